@@ -1,11 +1,86 @@
 ﻿#include "DynamicLambda.h"
 
 #include <chrono>
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
 #include "Misc/CoreDelegates.h"
 #include "Misc/StringBuilder.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 
 TUniquePtr<FDynamicLambdaManager> GDynamicLambdaManager;
 
+#if DYNAMIC_LAMBDA_PROFILER
+int32 GDynamicLambdaProfilerEnabled = 0;
+FAutoConsoleVariableRef CVarDynamicLambdaProfiler(
+	TEXT("DynamicLambda.Profiler"),
+	GDynamicLambdaProfilerEnabled,
+	TEXT("Record invocations and inclusive time of lambdas bound to dynamic delegates per bind call site"));
+
+FAutoConsoleCommand DynamicLambdaDumpProfileCommand(
+	TEXT("DynamicLambda.DumpProfile"),
+	TEXT("Print N (20 by default) lambda call sites sorted by inclusive time, number of calls or average time: [N] [time|calls|avg]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([] (const TArray<FString>& Args)
+	{
+		ELambdaProfileSortKey SortKey = ELambdaProfileSortKey::InclusiveTime;
+		if (Args.Num() > 1 && Args[1] == TEXT("calls"))
+		{
+			SortKey = ELambdaProfileSortKey::Calls;
+		}
+		else if (Args.Num() > 1 && Args[1] == TEXT("avg"))
+		{
+			SortKey = ELambdaProfileSortKey::AverageTime;
+		}
+
+		FDynamicLambdaManager::Get().DumpProfile(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 20, SortKey);
+	}));
+
+FAutoConsoleCommand DynamicLambdaResetProfileCommand(
+	TEXT("DynamicLambda.ResetProfile"),
+	TEXT("Reset lambda call sites statistics"),
+	FConsoleCommandDelegate::CreateLambda([] { FDynamicLambdaManager::Get().ResetProfile(); }));
+
+// Measures lambda invocation and emits trace event named after the call site instead of anonymous RouteToLambda
+class FLambdaProfilerScope
+{
+public:
+	explicit FLambdaProfilerScope(FLambdaCallSiteStats* InStats)
+		: Stats(InStats)
+	{
+		if (Stats != nullptr)
+		{
+#if CPUPROFILERTRACE_ENABLED
+			IsTraced = UE_TRACE_CHANNELEXPR_IS_ENABLED(CpuChannel);
+			if (IsTraced)
+			{
+				FCpuProfilerTrace::OutputBeginDynamicEvent(*Stats->Name);
+			}
+#endif // CPUPROFILERTRACE_ENABLED
+			StartCycles = FPlatformTime::Cycles64();
+		}
+	}
+
+	~FLambdaProfilerScope()
+	{
+		if (Stats != nullptr)
+		{
+			Stats->InclusiveCycles += FPlatformTime::Cycles64() - StartCycles;
+			++Stats->Calls;
+#if CPUPROFILERTRACE_ENABLED
+			if (IsTraced)
+			{
+				FCpuProfilerTrace::OutputEndEvent();
+			}
+#endif // CPUPROFILERTRACE_ENABLED
+		}
+	}
+
+private:
+	FLambdaCallSiteStats* Stats;
+	uint64 StartCycles = 0;
+	bool IsTraced = false;
+};
+#endif // DYNAMIC_LAMBDA_PROFILER
+
 FDynamicLambdaManager& FDynamicLambdaManager::Get()
 {
 	if (!GDynamicLambdaManager.IsValid())
@@ -16,26 +91,127 @@ FDynamicLambdaManager& FDynamicLambdaManager::Get()
 	return *GDynamicLambdaManager;
 }
 
+FDynamicLambdaManager* FDynamicLambdaManager::TryGet()
+{
+	return GDynamicLambdaManager.Get();
+}
+
+// Call site extracted from callable's type has no line number or has it already
+static void AppendLineNumber(FStringBuilderBase& Name, int32 LineNumber)
+{
+	if (LineNumber != 0)
+	{
+		Name << ':' << LineNumber;
+	}
+}
+
 FName FDynamicLambdaManager::GenerateLambdaName(FAnsiStringView FileName, int32 LineNumber)
 {
 	static int32 ID = 0;
 	TStringBuilder<256> Name;
 
-	Name << "lambda_" << ++ID << '_' << FileName << ':' << LineNumber;
-	
-	return FName(Name.ToString());
+	Name << "lambda_" << FileName;
+	AppendLineNumber(Name, LineNumber);
+
+	// Unique ID goes to the FName's number: all lambdas of the call site share the only name table entry
+	// otherwise every binding leaves a never freed entry in the name table
+	return FName(Name.ToString(), ++ID);
+}
+
+FName FDynamicLambdaManager::GenerateSharedLambdaName(FAnsiStringView FileName, int32 LineNumber)
+{
+	static int32 ID = 0;
+	TStringBuilder<256> Name;
+
+	Name << "lambda_shared_" << FileName;
+	AppendLineNumber(Name, LineNumber);
+
+	return FName(Name.ToString(), ++ID);
+}
+
+TArray<ANSICHAR> FDynamicLambdaManager::ExtractCallSite(const ANSICHAR* Signature)
+{
+	const ANSICHAR* Begin = Signature;
+	const ANSICHAR* End = Signature + FCStringAnsi::Strlen(Signature);
+
+	// Clang names lambda after its location: "[TCallable = (lambda at Path/File.cpp:42:10)]"
+	// GCC gives the enclosing function: "[with TCallable = AMyActor::BeginPlay()::<lambda()>]"
+	// MSVC gives a unique lambda id: "GetCallSite<class AMyActor::BeginPlay::<lambda_1f2e...>>(void)"
+	// Functors are named after their type by all of them
+	static constexpr ANSICHAR LambdaPrefix[] = "lambda at ";
+	static constexpr ANSICHAR ArgumentPrefix[] = "TCallable = ";
+	static constexpr ANSICHAR FunctionPrefix[] = "GetCallSite<";
+	if (const ANSICHAR* Lambda = FCStringAnsi::Strstr(Signature, LambdaPrefix))
+	{
+		Begin = Lambda + UE_ARRAY_COUNT(LambdaPrefix) - 1;
+		for (const ANSICHAR* It = Begin; It != End && *It != ')'; ++It)
+		{
+			// directories are dropped the same way as from __FILE__ in the log
+			if (*It == '/' || *It == '\\')
+			{
+				Begin = It + 1;
+			}
+		}
+		End = FCStringAnsi::Strchr(Begin, ')');
+	}
+	else if (const ANSICHAR* Argument = FCStringAnsi::Strstr(Signature, ArgumentPrefix))
+	{
+		Begin = Argument + UE_ARRAY_COUNT(ArgumentPrefix) - 1;
+		End = FCStringAnsi::Strrchr(Begin, ']');
+	}
+	else if (const ANSICHAR* Function = FCStringAnsi::Strstr(Signature, FunctionPrefix))
+	{
+		Begin = Function + UE_ARRAY_COUNT(FunctionPrefix) - 1;
+		End = FCStringAnsi::Strrchr(Begin, '>');
+	}
+
+	if (End == nullptr)
+	{
+		End = Signature + FCStringAnsi::Strlen(Signature);
+	}
+
+	// Tail of a long type name is more specific than its namespaces, and the name has to fit into FName
+	constexpr int32 MaxCallSiteLen = 200;
+	Begin = FMath::Max(Begin, End - MaxCallSiteLen);
+
+	// The call site becomes a part of UFunction's name, so only name friendly characters are kept
+	TArray<ANSICHAR> CallSite;
+	CallSite.Reserve(static_cast<int32>(End - Begin));
+	for (const ANSICHAR* It = Begin; It != End; ++It)
+	{
+		bool IsNameChar = FCharAnsi::IsAlnum(*It) || *It == '_' || *It == '.' || *It == ':';
+		CallSite.Add(IsNameChar ? *It : '_');
+	}
+
+	return CallSite;
 }
 
 FDynamicLambdaManager::FDynamicLambdaManager()
 {
-	auto PreGCHandler = [this] { OnPreGarbageCollect(); };
-	auto PostGCHandler = [this] { OnPostGarbageCollect(); };
+	auto PreGCHandler = [this]
+	{
+		double StartTime = FPlatformTime::Seconds();
+		OnPreGarbageCollect();
+		LastPreGarbageCollectMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	};
+	auto PostGCHandler = [this]
+	{
+		double StartTime = FPlatformTime::Seconds();
+		OnPostGarbageCollect();
+		LastPostGarbageCollectMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	};
 	EnginePreExitHandle = FCoreDelegates::OnEnginePreExit.AddLambda([] { GDynamicLambdaManager.Reset(); });
 
 	// Subscribe on GC to manage lambda's lifetime: it must be destroyed if delegate owner or subscriber is destroyed
 	PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddLambda(PreGCHandler);
 	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddLambda(PostGCHandler);
 
+	// Collapsed calls of coalesced, throttled and debounced lambdas are invoked at the end of frame
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FDynamicLambdaManager::OnEndFrame);
+
+	// Level's lambdas are released with the world, without waiting for delegates resolving and GC
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddRaw(this, &FDynamicLambdaManager::OnWorldCleanup);
+
 	// Create an anonymous object to able binding lambda without UObject
 	AnonymousObject = NewObject<UAnonymousObject>();
 	AnonymousObject->AddToRoot();
@@ -44,12 +220,116 @@ FDynamicLambdaManager::FDynamicLambdaManager()
 FDynamicLambdaManager::~FDynamicLambdaManager()
 {
 	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
 	FCoreDelegates::OnEnginePreExit.Remove(EnginePreExitHandle);
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
 
 	AnonymousObject->RemoveFromRoot();
 	AnonymousObject->MarkPendingKill();
 }
 
+FDynamicLambdaStats FDynamicLambdaManager::GetStats() const
+{
+	FDynamicLambdaStats Stats;
+	Stats.NumStorageBuckets = Storage.Num();
+	Stats.NumPooledFunctions = static_cast<int32>(FunctionPool.Num());
+	Stats.NumGroups = Groups.Num();
+	Stats.LastPreGarbageCollectMs = LastPreGarbageCollectMs;
+	Stats.LastPostGarbageCollectMs = LastPostGarbageCollectMs;
+
+	for (const auto& ClassKV : Storage)
+	{
+		Stats.NumLambdas += ClassKV.Value.Num();
+		for (const auto& KV : ClassKV.Value)
+		{
+			Stats.NumBindings += KV.Value.Bindings.Num();
+			Stats.NumMappedRouters += ClassKV.Key->FindFunctionByName(KV.Key) != nullptr ? 1 : 0;
+		}
+		Stats.NumClassNativeFunctions += ClassKV.Key->NativeFunctionLookupTable.Num();
+	}
+
+	// Pooled UFunction keeps its last class as outer until reuse, but the class mustn't resolve it anymore
+	FunctionPool.ForEach([&] (UFunction* Function)
+	{
+		UClass* Class = Cast<UClass>(Function->GetOuter());
+		Stats.NumStaleMappedFunctions += Class != nullptr && Class->FindFunctionByName(Function->GetFName()) == Function ? 1 : 0;
+	});
+
+	return Stats;
+}
+
+#if DYNAMIC_LAMBDA_PROFILER
+FLambdaCallSiteStats* FDynamicLambdaManager::FindOrAddCallSiteStats(FName LambdaName)
+{
+	// Lambda names differ by FName's number only, the name itself is the call site
+	FName CallSite(LambdaName, NAME_NO_NUMBER_INTERNAL);
+	TUniquePtr<FLambdaCallSiteStats>& Stats = CallSiteStats.FindOrAdd(CallSite);
+	if (!Stats.IsValid())
+	{
+		Stats = MakeUnique<FLambdaCallSiteStats>();
+		Stats->Name = CallSite.ToString();
+	}
+
+	return Stats.Get();
+}
+
+TArray<FLambdaCallSiteStats> FDynamicLambdaManager::GetProfile(ELambdaProfileSortKey SortKey) const
+{
+	TArray<FLambdaCallSiteStats> Profile;
+	for (const auto& KV : CallSiteStats)
+	{
+		if (KV.Value->Calls != 0)
+		{
+			Profile.Add(*KV.Value);
+		}
+	}
+
+	Profile.Sort([SortKey] (const FLambdaCallSiteStats& Lhs, const FLambdaCallSiteStats& Rhs)
+	{
+		switch (SortKey)
+		{
+		case ELambdaProfileSortKey::Calls:
+			return Lhs.Calls > Rhs.Calls;
+
+		case ELambdaProfileSortKey::AverageTime:
+			// calls are never 0 here, cross multiplication avoids division
+			return Lhs.InclusiveCycles * Rhs.Calls > Rhs.InclusiveCycles * Lhs.Calls;
+
+		default:
+			return Lhs.InclusiveCycles > Rhs.InclusiveCycles;
+		}
+	});
+
+	return Profile;
+}
+
+void FDynamicLambdaManager::DumpProfile(int32 MaxCallSites, ELambdaProfileSortKey SortKey) const
+{
+	TArray<FLambdaCallSiteStats> Profile = GetProfile(SortKey);
+	int32 NumCallSites = FMath::Min(MaxCallSites, Profile.Num());
+
+	UE_LOG(LogTemp, Display, TEXT("Dynamic lambda profile, top %d of %d call sites:"), NumCallSites, Profile.Num());
+	UE_LOG(LogTemp, Display, TEXT("%12s %12s %12s  %s"), TEXT("Calls"), TEXT("Total, ms"), TEXT("Avg, us"), TEXT("Call site"));
+	for (int32 Idx = 0; Idx < NumCallSites; ++Idx)
+	{
+		const FLambdaCallSiteStats& Stats = Profile[Idx];
+		double Ms = FPlatformTime::ToMilliseconds64(Stats.InclusiveCycles);
+		UE_LOG(LogTemp, Display, TEXT("%12llu %12.3f %12.3f  %s"), Stats.Calls, Ms, Ms * 1000.0 / Stats.Calls, *Stats.Name);
+	}
+}
+
+void FDynamicLambdaManager::ResetProfile()
+{
+	// Stats are kept: they are referenced by lambda storages
+	for (auto& KV : CallSiteStats)
+	{
+		KV.Value->Calls = 0;
+		KV.Value->InclusiveCycles = 0;
+	}
+}
+#endif // DYNAMIC_LAMBDA_PROFILER
+
 void FDynamicLambdaManager::CreateLambdaRouter(UClass* ObjectClass, FName LambdaName)
 {
 	ObjectClass->AddNativeFunction(*LambdaName.ToString(), RouteToLambda);
@@ -62,9 +342,9 @@ void FDynamicLambdaManager::CreateLambdaRouter(UClass* ObjectClass, FName Lambda
 
 UFunction* FDynamicLambdaManager::CreateFunction(UClass* ObjectClass, FName Name)
 {
-	if (FunctionPool.Num() != 0)
+	if (!FunctionPool.IsEmpty())
 	{
-		UFunction* Function = FunctionPool.Pop(false);
+		UFunction* Function = FunctionPool.Acquire();
 		Function->Rename(*Name.ToString(), ObjectClass, REN_DontCreateRedirectors | REN_DoNotDirty);
 
 		checkf(Function->GetFName() == Name, TEXT("Name is different"));
@@ -87,26 +367,538 @@ void FDynamicLambdaManager::RouteToLambda(UObject* Context, FFrame& Stack, RESUL
 	P_FINISH;
 	P_NATIVE_BEGIN;
 
+	FDynamicLambdaManager& Manager = Get();
+	UClass* Class = Context->GetClass();
 	FName LambdaName = Stack.CurrentNativeFunction->GetFName();
-	Get().Storage[Context->GetClass()][LambdaName].Lambda();
-			
+	FLambdaStorage& LambdaStorage = Manager.Storage[Class][LambdaName];
+
+	// Released lambda still can be reached from the invocation list copy of the multicast delegate being broadcast
+	if (LambdaStorage.IsReleased)
+	{
+		return;
+	}
+
+	if (LambdaStorage.Policy != ELambdaInvokePolicy::Immediate && Manager.TryDeferInvocation(Class, LambdaName, LambdaStorage))
+	{
+		return;
+	}
+
+	Manager.InvokeLambda(Class, LambdaName, LambdaStorage);
+
 	P_NATIVE_END;
 }
 
-void FDynamicLambdaManager::StoreLambda(FName LambdaName, UObject* Object, FDelegateData DelegateData, TFunction<void()>&& Lambda)
+void FDynamicLambdaManager::InvokeLambda(UClass* Class, FName LambdaName, FLambdaStorage& LambdaStorage)
 {
-	UClass* ObjectClass = Object->GetClass();
+	++RouteDepth;
+	{
+#if DYNAMIC_LAMBDA_PROFILER
+		// Stats are found on the first profiled invocation: binding costs nothing while profiler is off,
+		// and lambdas bound before it's switched on are profiled too
+		if (GDynamicLambdaProfilerEnabled != 0 && LambdaStorage.CallSiteStats == nullptr)
+		{
+			LambdaStorage.CallSiteStats = FindOrAddCallSiteStats(LambdaName);
+		}
+		FLambdaProfilerScope ProfilerScope(GDynamicLambdaProfilerEnabled != 0 ? LambdaStorage.CallSiteStats : nullptr);
+#endif // DYNAMIC_LAMBDA_PROFILER
 
-	auto ClassStorage = Storage.Find(ObjectClass);
-	if (ClassStorage == nullptr)
+		if (LambdaStorage.RemainingInvocations != INDEX_NONE && --LambdaStorage.RemainingInvocations == 0)
+		{
+			// Last invocation: unbind first so lambda can safely rebind itself or broadcast the same delegate,
+			// and move lambda out of the storage to destroy its captures right after the call
+			TFunction<void()> Lambda = MoveTemp(LambdaStorage.Lambda);
+			ReleaseLambda(Class, LambdaName);
+			Lambda();
+		}
+		else
+		{
+			LambdaStorage.Lambda();
+		}
+	}
+
+	if (--RouteDepth == 0)
+	{
+		FlushPendingReleases();
+	}
+}
+
+bool FDynamicLambdaManager::TryDeferInvocation(UClass* Class, FName LambdaName, FLambdaStorage& LambdaStorage)
+{
+	double Now = FPlatformTime::Seconds();
+	switch (LambdaStorage.Policy)
+	{
+	case ELambdaInvokePolicy::Immediate:
+		return false;
+
+	case ELambdaInvokePolicy::Coalesce:
+		break;
+
+	case ELambdaInvokePolicy::Throttle:
+		if (!LambdaStorage.IsPending && Now - LambdaStorage.LastInvokeTime >= LambdaStorage.Interval)
+		{
+			LambdaStorage.LastInvokeTime = Now;
+			return false;
+		}
+		LambdaStorage.PendingDeadline = LambdaStorage.LastInvokeTime + LambdaStorage.Interval;
+		break;
+
+	case ELambdaInvokePolicy::Debounce:
+		LambdaStorage.PendingDeadline = Now + LambdaStorage.Interval;
+		break;
+	}
+
+	// Calls are collapsed to the only pending invocation
+	if (!LambdaStorage.IsPending)
 	{
-		ClassStorage = &Storage.Add(ObjectClass);
+		LambdaStorage.IsPending = true;
+		PendingInvocations.Add({ Class, LambdaName });
 	}
 
-	FLambdaStorage& LambdaStorage = ClassStorage->Add(LambdaName);
-	LambdaStorage.DelegateData = DelegateData;
-	LambdaStorage.LambdaOwner = Object;
+	return true;
+}
+
+void FDynamicLambdaManager::OnEndFrame()
+{
+	FlushPendingInvocations();
+}
+
+void FDynamicLambdaManager::FlushPendingInvocations()
+{
+	if (PendingInvocations.Num() == 0)
+	{
+		return;
+	}
+
+	// Calls collapsed by invoked lambdas wait for the next frame
+	double Now = FPlatformTime::Seconds();
+	TArray<TPair<UClass*, FName>> Invocations = MoveTemp(PendingInvocations);
+	for (const TPair<UClass*, FName>& Invocation : Invocations)
+	{
+		// lambda could be released, cleaned up by GC or lost any of its owners since the call
+		// Lambda with invoke policy never shares its router, so it has the only binding
+		FLambdaStorage* LambdaStorage = FindLambdaStorage(Invocation.Key, Invocation.Value);
+		if (LambdaStorage == nullptr || LambdaStorage->IsReleased)
+		{
+			continue;
+		}
+
+		const FLambdaBinding& Binding = LambdaStorage->Bindings[0];
+		bool IsDelegateAlive = Binding.DelegateOwner.IsValid() || Binding.DelegateOwner.IsExplicitlyNull();
+		if (!Binding.LambdaOwner.IsValid() || !IsDelegateAlive)
+		{
+			continue;
+		}
+
+		if (Now < LambdaStorage->PendingDeadline)
+		{
+			PendingInvocations.Add(Invocation);
+			continue;
+		}
+
+		LambdaStorage->IsPending = false;
+		LambdaStorage->LastInvokeTime = Now;
+		InvokeLambda(Invocation.Key, Invocation.Value, *LambdaStorage);
+	}
+}
+
+FLambdaStorage& FDynamicLambdaManager::StoreLambda(FName LambdaName, UObject* Object, const FLambdaBinding& Binding, TFunction<void()>&& Lambda, const FLambdaBindOptions& Options)
+{
+	FLambdaStorage& LambdaStorage = AddLambdaStorage(Object->GetClass(), LambdaName);
+	LambdaStorage.Bindings.Add(Binding);
 	LambdaStorage.Lambda = MoveTemp(Lambda);
+	LambdaStorage.RemainingInvocations = Options.MaxInvocations;
+	LambdaStorage.Policy = Options.Policy;
+	LambdaStorage.Interval = Options.Interval;
+
+	// scope of already released group doesn't catch lambdas, they are released with their world instead
+	if (CurrentGroup.IsValid() && Groups.Contains(CurrentGroup.Id))
+	{
+		AddToGroup(CurrentGroup.Id, Object->GetClass(), LambdaName, LambdaStorage);
+	}
+	else
+	{
+		AddToWorldGroup(GetBindingWorld(Binding), Object->GetClass(), LambdaName, LambdaStorage);
+	}
+
+	return LambdaStorage;
+}
+
+FLambdaStorage* FDynamicLambdaManager::FindLambdaStorage(UClass* Class, FName LambdaName)
+{
+	TMap<FName, FLambdaStorage>* ClassStorage = Storage.Find(Class);
+	return ClassStorage != nullptr ? ClassStorage->Find(LambdaName) : nullptr;
+}
+
+FLambdaStorage& FDynamicLambdaManager::AddLambdaStorage(UClass* Class, FName LambdaName)
+{
+	auto ClassStorage = Storage.Find(Class);
+	if (ClassStorage == nullptr)
+	{
+		ClassStorage = &Storage.Add(Class);
+	}
+
+	return ClassStorage->Add(LambdaName);
+}
+
+void FDynamicLambdaManager::ReleaseLambda(UClass* Class, FName LambdaName)
+{
+	FLambdaStorage& LambdaStorage = Storage[Class][LambdaName];
+	if (LambdaStorage.IsReleased)
+	{
+		return;
+	}
+
+	for (const FLambdaBinding& Binding : LambdaStorage.Bindings)
+	{
+		UnbindFromDelegate(Binding, LambdaName, LambdaStorage.SparseDelegateRemover);
+	}
+	LambdaStorage.IsReleased = true;
+
+	// UFunction of running router must stay registered until the router returns
+	// Broadcast skips the rest of released lambdas: their UFunctions can't be found anymore after clean up
+	if (RouteDepth > 0)
+	{
+		PendingReleases.Add({ Class, LambdaName });
+		return;
+	}
+
+	CleanUpLambda(Class, LambdaName);
+}
+
+void FDynamicLambdaManager::ReleaseLambdaIfBound(UClass* Class, FName LambdaName)
+{
+	// Lambda names are never reused, so the name can't point to another lambda
+	FLambdaStorage* LambdaStorage = FindLambdaStorage(Class, LambdaName);
+	if (LambdaStorage != nullptr && !LambdaStorage->IsReleased)
+	{
+		ReleaseLambda(Class, LambdaName);
+	}
+}
+
+void FDynamicLambdaManager::FlushPendingReleases()
+{
+	TArray<TPair<UClass*, FName>> Releases = MoveTemp(PendingReleases);
+	for (const TPair<UClass*, FName>& Release : Releases)
+	{
+		// lambda could be already cleaned up by GC triggered from user's code
+		if (FindLambdaStorage(Release.Key, Release.Value) != nullptr)
+		{
+			CleanUpLambda(Release.Key, Release.Value);
+		}
+	}
+
+	TArray<FLambdaGroup> GroupReleases = MoveTemp(PendingGroupReleases);
+	for (const FLambdaGroup& Group : GroupReleases)
+	{
+		CleanUpGroup(Group);
+	}
+}
+
+FLambdaGroupHandle FDynamicLambdaManager::CreateGroup()
+{
+	FLambdaGroupHandle Handle;
+	Handle.Id = ++LastGroupId;
+	Groups.Add(Handle.Id);
+
+	return Handle;
+}
+
+void FDynamicLambdaManager::ReleaseGroup(FLambdaGroupHandle Handle)
+{
+	FLambdaGroup Group;
+	if (!Groups.RemoveAndCopyValue(Handle.Id, Group))
+	{
+		return;
+	}
+
+	if (Group.World != nullptr)
+	{
+		WorldGroups.Remove(Group.World);
+		ReleaseWorldBindings(Handle.Id, Group);
+	}
+
+	// Unbind every lambda of the group, lambdas already released alone are cleaned up by pending releases
+	for (auto& ClassKV : Group.Lambdas)
+	{
+		TMap<FName, FLambdaStorage>& ClassStorage = Storage[ClassKV.Key];
+		for (FName LambdaName : ClassKV.Value)
+		{
+			FLambdaStorage& LambdaStorage = ClassStorage[LambdaName];
+			LambdaStorage.GroupId = 0;
+			if (LambdaStorage.IsReleased)
+			{
+				continue;
+			}
+
+			for (const FLambdaBinding& Binding : LambdaStorage.Bindings)
+			{
+				UnbindFromDelegate(Binding, LambdaName, LambdaStorage.SparseDelegateRemover);
+			}
+			LambdaStorage.IsReleased = true;
+		}
+	}
+
+	// The same as for single lambda: UFunction of running router must stay registered until the router returns
+	if (RouteDepth > 0)
+	{
+		PendingGroupReleases.Add(MoveTemp(Group));
+		return;
+	}
+
+	CleanUpGroup(Group);
+}
+
+void FDynamicLambdaManager::ReleaseWorldBindings(uint32 GroupId, FLambdaGroup& Group)
+{
+	// Shared routers serve other worlds too: only the world's bindings are removed,
+	// routers without bindings are released with the rest of the group
+	for (auto& ClassKV : Group.SharedLambdas)
+	{
+		for (FName LambdaName : ClassKV.Value)
+		{
+			// shared router could be already cleaned up by GC
+			FLambdaStorage* LambdaStorage = FindLambdaStorage(ClassKV.Key, LambdaName);
+			if (LambdaStorage == nullptr || LambdaStorage->IsReleased)
+			{
+				continue;
+			}
+
+			LambdaStorage->WorldGroupIds.RemoveSwap(GroupId);
+
+			LambdaStorage->Bindings.RemoveAllSwap([&] (const FLambdaBinding& Binding)
+			{
+				if (!IsBoundInWorld(Binding, Group.World))
+				{
+					return false;
+				}
+
+				UnbindFromDelegate(Binding, LambdaName, LambdaStorage->SparseDelegateRemover);
+				return true;
+			}, false);
+
+			if (LambdaStorage->Bindings.Num() == 0)
+			{
+				LambdaStorage->IsReleased = true;
+				Group.Lambdas.FindOrAdd(ClassKV.Key).Add(LambdaName);
+			}
+		}
+	}
+}
+
+UWorld* FDynamicLambdaManager::GetObjectWorld(UObject* Object)
+{
+	if (Object == nullptr)
+	{
+		return nullptr;
+	}
+
+	return Object->IsA<UWorld>() ? static_cast<UWorld*>(Object) : Object->GetTypedOuter<UWorld>();
+}
+
+UWorld* FDynamicLambdaManager::GetBindingWorld(const FLambdaBinding& Binding)
+{
+	// Lambda dies with any of its owners, so the world of any known owner fits
+	UWorld* World = GetObjectWorld(Binding.LambdaOwner.Get());
+	return World != nullptr ? World : GetObjectWorld(Binding.DelegateOwner.Get());
+}
+
+bool FDynamicLambdaManager::IsBoundInWorld(const FLambdaBinding& Binding, UWorld* World)
+{
+	// owners of the cleaned up world can be already marked as pending kill
+	return GetObjectWorld(Binding.LambdaOwner.Get(true)) == World || GetObjectWorld(Binding.DelegateOwner.Get(true)) == World;
+}
+
+void FDynamicLambdaManager::AddToWorldGroup(UWorld* World, UClass* Class, FName LambdaName, FLambdaStorage& LambdaStorage)
+{
+	uint32 GroupId = GetWorldGroupId(World);
+	if (!LambdaStorage.IsShared)
+	{
+		AddToGroup(GroupId, Class, LambdaName, LambdaStorage);
+		return;
+	}
+
+	if (FLambdaGroup* Group = Groups.Find(GroupId))
+	{
+		Group->SharedLambdas.FindOrAdd(Class).Add(LambdaName);
+		LambdaStorage.WorldGroupIds.AddUnique(GroupId);
+	}
+}
+
+uint32 FDynamicLambdaManager::GetWorldGroupId(UWorld* World)
+{
+	if (World == nullptr)
+	{
+		return 0;
+	}
+
+	uint32& GroupId = WorldGroups.FindOrAdd(World);
+	if (GroupId == 0)
+	{
+		GroupId = CreateGroup().Id;
+		Groups[GroupId].World = World;
+	}
+
+	return GroupId;
+}
+
+void FDynamicLambdaManager::AddToGroup(uint32 GroupId, UClass* Class, FName LambdaName, FLambdaStorage& LambdaStorage)
+{
+	// released group doesn't accept lambdas anymore
+	FLambdaGroup* Group = Groups.Find(GroupId);
+	if (Group == nullptr)
+	{
+		return;
+	}
+
+	Group->Lambdas.FindOrAdd(Class).Add(LambdaName);
+	LambdaStorage.GroupId = GroupId;
+}
+
+void FDynamicLambdaManager::RemoveFromGroup(UClass* Class, FName LambdaName, FLambdaStorage& LambdaStorage)
+{
+	RemoveFromWorldGroups(Class, LambdaName, LambdaStorage);
+
+	uint32 GroupId = LambdaStorage.GroupId;
+	FLambdaGroup* Group = Groups.Find(GroupId);
+	LambdaStorage.GroupId = 0;
+	if (Group == nullptr)
+	{
+		return;
+	}
+
+	TSet<FName>& ClassLambdas = Group->Lambdas[Class];
+	ClassLambdas.Remove(LambdaName);
+	if (ClassLambdas.Num() == 0)
+	{
+		Group->Lambdas.Remove(Class);
+	}
+
+	ForgetEmptyWorldGroup(GroupId, *Group);
+}
+
+void FDynamicLambdaManager::RemoveFromWorldGroups(UClass* Class, FName LambdaName, FLambdaStorage& LambdaStorage)
+{
+	for (uint32 GroupId : LambdaStorage.WorldGroupIds)
+	{
+		FLambdaGroup* Group = Groups.Find(GroupId);
+		if (Group == nullptr)
+		{
+			continue;
+		}
+
+		if (TSet<FName>* ClassLambdas = Group->SharedLambdas.Find(Class))
+		{
+			ClassLambdas->Remove(LambdaName);
+			if (ClassLambdas->Num() == 0)
+			{
+				Group->SharedLambdas.Remove(Class);
+			}
+		}
+
+		ForgetEmptyWorldGroup(GroupId, *Group);
+	}
+
+	LambdaStorage.WorldGroupIds.Reset();
+}
+
+void FDynamicLambdaManager::ForgetEmptyWorldGroup(uint32 GroupId, const FLambdaGroup& Group)
+{
+	// Nobody holds handle of the world's group, so empty one is forgotten: world could be already cleaned up
+	if (Group.World != nullptr && Group.Lambdas.Num() == 0 && Group.SharedLambdas.Num() == 0)
+	{
+		WorldGroups.Remove(Group.World);
+		Groups.Remove(GroupId);
+	}
+}
+
+void FDynamicLambdaManager::CleanUpGroup(const FLambdaGroup& Group)
+{
+	for (const auto& ClassKV : Group.Lambdas)
+	{
+		CleanUpLambdas(ClassKV.Key, ClassKV.Value);
+	}
+}
+
+void FDynamicLambdaManager::CleanUpLambdas(UClass* Class, const TSet<FName>& LambdaNames)
+{
+	// lambdas could be already cleaned up by GC or by pending releases
+	TMap<FName, FLambdaStorage>& ClassStorage = Storage[Class];
+	TArray<FName, TInlineAllocator<64>> LambdasToRemove;
+	for (FName LambdaName : LambdaNames)
+	{
+		FLambdaStorage* LambdaStorage = ClassStorage.Find(LambdaName);
+		if (LambdaStorage == nullptr)
+		{
+			continue;
+		}
+
+		// shared router released with one world can be still listed by other worlds
+		RemoveFromWorldGroups(Class, LambdaName, *LambdaStorage);
+		ClassStorage.Remove(LambdaName);
+		LambdasToRemove.Add(LambdaName);
+	}
+
+	if (LambdasToRemove.Num() == 0)
+	{
+		return;
+	}
+
+	// One compaction of the class's native functions instead of a search per lambda
+	Class->NativeFunctionLookupTable.RemoveAllSwap([&] (const FNativeFunctionLookup& Item)
+	{
+		return LambdaNames.Contains(Item.Name);
+	}, false);
+
+	for (FName LambdaName : LambdasToRemove)
+	{
+		UFunction* Function = Class->FindFunctionByName(LambdaName);
+		Class->RemoveFunctionFromFunctionMap(Function);
+		FunctionPool.Release(Function);
+	}
+}
+
+void FDynamicLambdaManager::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	if (const uint32* GroupId = WorldGroups.Find(World))
+	{
+		FLambdaGroupHandle Handle;
+		Handle.Id = *GroupId;
+		ReleaseGroup(Handle);
+	}
+}
+
+void FDynamicLambdaManager::UnbindFromDelegate(const FLambdaBinding& Binding, FName LambdaName, FSparseDelegateRemover SparseDelegateRemover)
+{
+	// Delegate pointer is valid only while its owner is alive or isn't resolved yet
+	UObject* LambdaOwner = Binding.LambdaOwner.Get();
+	bool IsDelegateAlive = Binding.DelegateOwner.IsValid() || Binding.DelegateOwner.IsExplicitlyNull();
+	if (LambdaOwner == nullptr || !IsDelegateAlive)
+	{
+		return;
+	}
+
+	void* Pointer = const_cast<void*>(Binding.DelegateData.Pointer);
+	switch (Binding.DelegateData.Kind)
+	{
+	case EDynamicDelegateKind::Single:
+		{
+			FScriptDelegate* Delegate = static_cast<FScriptDelegate*>(Pointer);
+			if (Delegate->GetUObject() == LambdaOwner && Delegate->GetFunctionName() == LambdaName)
+			{
+				Delegate->Unbind();
+			}
+		}
+		break;
+
+	case EDynamicDelegateKind::Multicast:
+		static_cast<FMulticastScriptDelegate*>(Pointer)->Remove(LambdaOwner, LambdaName);
+		break;
+
+	case EDynamicDelegateKind::Sparse:
+		// sparse delegate's invocation list is stored outside, only the concrete delegate type knows where
+		SparseDelegateRemover(Pointer, LambdaOwner, LambdaName);
+		break;
+	}
 }
 
 void FDynamicLambdaManager::OnPreGarbageCollect()
@@ -136,6 +928,29 @@ void FDynamicLambdaManager::OnPreGarbageCollect()
 	
 	double Ms = (End - Start).count() / 1000000.0;
 	UE_LOG(LogTemp, Display, TEXT("Delegates resolving time: %f ms"), Ms);
+
+	AddResolvedToWorldGroups(DelegatesToResolve);
+}
+
+void FDynamicLambdaManager::AddResolvedToWorldGroups(const FDelegateResolvingDataItems& ResolvedDelegates)
+{
+	// Anonymous lambda's world is known only after its delegate owner is resolved, that happens once per binding
+	for (const FDelegateResolvingData& Data : ResolvedDelegates)
+	{
+		UObject* DelegateOwner = Data.DelegateOwnerPtr->Get();
+		UObject* LambdaOwner = Data.LambdaOwner.Get();
+		if (DelegateOwner == nullptr || LambdaOwner == nullptr)
+		{
+			continue;
+		}
+
+		UClass* Class = LambdaOwner->GetClass();
+		FLambdaStorage& LambdaStorage = Storage[Class][Data.LambdaName];
+		if (LambdaStorage.IsShared || LambdaStorage.GroupId == 0)
+		{
+			AddToWorldGroup(GetObjectWorld(DelegateOwner), Class, Data.LambdaName, LambdaStorage);
+		}
+	}
 }
 
 void FDynamicLambdaManager::OnPostGarbageCollect()
@@ -143,11 +958,12 @@ void FDynamicLambdaManager::OnPostGarbageCollect()
 	// Time after GC is perfect time to process some housekeeping tasks
 	for (auto& ClassKV : Storage)
 	{
-		// Gather lambdas bound to GCed objects
+		// Forget delegates bound to GCed objects and gather lambdas without delegates
 		TArray<FName, TInlineAllocator<64>> LambdasToRemove;
 		for (auto& KV : ClassKV.Value)
 		{
-			if (!KV.Value.IsValid())
+			KV.Value.Bindings.RemoveAllSwap([] (const FLambdaBinding& Binding) { return !Binding.IsValid(); }, false);
+			if (KV.Value.Bindings.Num() == 0)
 			{
 				LambdasToRemove.Add(KV.Key);
 			}
@@ -167,91 +983,100 @@ void FDynamicLambdaManager::GatherDelegatesToResolve(FDelegateResolvingDataItems
 	{
 		for (auto& KV : ClassKV.Value)
 		{
-			// Empty DelegateOwner means that it's never been resolved
-			// If lambda owner is already dead, skip resolving: lambda will be destroyed after GC 
-			if (KV.Value.DelegateOwner.IsExplicitlyNull() && KV.Value.LambdaOwner.IsValid())
+			// Released lambdas are waiting for clean up and don't need their delegates anymore
+			if (KV.Value.IsReleased)
+			{
+				continue;
+			}
+
+			for (FLambdaBinding& Binding : KV.Value.Bindings)
 			{
-				DelegatesToResolve.Add({ KV.Value, KV.Key });
+				// Empty DelegateOwner means that it's never been resolved
+				// If lambda owner is already dead, skip resolving: lambda will be destroyed after GC 
+				if (Binding.DelegateOwner.IsExplicitlyNull() && Binding.LambdaOwner.IsValid())
+				{
+					DelegatesToResolve.Add({ Binding, KV.Key });
+				}
 			}
 		}
 	}
 
-	// Sort items to allow skipping UObjects located in memory after delegates to resolve
-	DelegatesToResolve.Sort([] (const FDelegateResolvingData& Lhs, const FDelegateResolvingData& Rhs)
-	{
-		return Lhs.DelegateData.Pointer < Rhs.DelegateData.Pointer;
-	});
+	// Sort items to allow skipping UObjects located in memory out of delegates to resolve
+	FDelegateResolvingData* First = DelegatesToResolve.GetData();
+	DynamicLambdaCore::SortByAddress(First, First + DelegatesToResolve.Num(), GetDelegatePointer);
 }
 
-void FDynamicLambdaManager::ResolveDelegates(FDelegateResolvingDataItems& ObjectsToResolve)
+// UObject as DynamicLambdaCore resolving sees it
+struct FDynamicLambdaManager::FResolvingObject
 {
-	std::atomic<int32> ResolvedDelegatesCounter;
+	FUObjectItem* Item;
+	std::atomic<int32>& Counter;
 
-	int32 MaxObjects = GUObjectArray.GetObjectArrayNum() - GUObjectArray.GetFirstGCIndex();
-	int32 Threads = FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads());
-	int32 ObjectsPerThread = (GUObjectArray.GetObjectArrayNum() / Threads) + 1;
+	UObject* GetObject() const { return static_cast<UObject*>(Item->Object); }
+	const void* GetAddress() const { return Item->Object; }
+	size_t GetSize() const { return GetObject()->GetClass()->GetPropertiesSize(); }
+	bool ShouldSkip() const { return ShouldSkipObject(Item); }
 
-	// Iterate over all objects in parallel way
-	// ObjectsToResolve doesn't need any synchronization: there are no intersections between threads
-	// All threads are processing different UObject sets
-	ParallelFor(Threads, [&] (int32 Id)
+	template <typename TVisitor>
+	void ForEachProperty(TVisitor&& Visitor) const
 	{
-		int32 FirstObjectIndex = Id * ObjectsPerThread + GUObjectArray.GetFirstGCIndex();
-		int32 NumObjects = Id < Threads - 1 ? ObjectsPerThread : MaxObjects - (Threads - 1) * ObjectsPerThread;
-		int32 LastObjectIndex = FMath::Min(GUObjectArray.GetObjectArrayNum() - 1, FirstObjectIndex + NumObjects - 1);
-
-		for (int32 Idx = FirstObjectIndex; Idx <= LastObjectIndex; ++Idx)
+		for (TFieldIterator<FProperty> PropsIt(GetObject()->GetClass()); PropsIt; ++PropsIt)
 		{
-			FUObjectItem* Item = GUObjectArray.IndexToObjectUnsafeForGC(Idx);
-			TryResolveDelegate(Item, ObjectsToResolve, ResolvedDelegatesCounter);
-
-			// at the end of iteration check if all delegates were resolved
-			if (ResolvedDelegatesCounter.load(std::memory_order_relaxed) == ObjectsToResolve.Num())
-			{
-				break;
-			}
+			Visitor(PropsIt->GetOffset_ForInternal(), *PropsIt);
 		}
-	});
-}
-
-void FDynamicLambdaManager::TryResolveDelegate(FUObjectItem* Item, FDelegateResolvingDataItems& ObjectsToResolve, std::atomic<int32>& Counter)
-{
-	UObject* Object = static_cast<UObject*>(Item->Object);
-	if (ShouldSkipObject(Item, ObjectsToResolve.Last().DelegateData.Pointer))
-	{
-		return;
 	}
 
-	const char* ObjectBytePtr = reinterpret_cast<const char*>(Object); 
-	for (TFieldIterator<FProperty> PropsIt(Object->GetClass()); PropsIt; ++PropsIt)
+	bool TryResolve(FDelegateResolvingData& ObjectToResolve, FProperty* Property) const
 	{
-		for (FDelegateResolvingData& ObjectToResolve : ObjectsToResolve)
+		// check that found property literally is the same delegate
+		if (!IsTheSameDelegate(ObjectToResolve.DelegateData.Pointer, Property, ObjectToResolve))
 		{
-			const void* Pointer = ObjectToResolve.DelegateData.Pointer;
-			if ((Pointer != nullptr) & (ObjectBytePtr + PropsIt->GetOffset_ForInternal() == Pointer))
-			{
-				// check that found property literally is the same delegate
-				if (IsTheSameDelegate(Pointer, *PropsIt, ObjectToResolve))
-				{
-					// delegate owner found, mark it as resolved
-					*ObjectToResolve.DelegateOwnerPtr = Object;
-					ObjectToResolve.DelegateData.Pointer = nullptr;
-					++Counter;
-				}
-			}
+			return false;
 		}
+
+		// delegate owner found, mark it as resolved
+		// every delegate lies inside the only object, so there are no races between threads
+		*ObjectToResolve.DelegateOwnerPtr = GetObject();
+		++Counter;
+		return true;
 	}
+};
+
+void FDynamicLambdaManager::ResolveDelegates(FDelegateResolvingDataItems& ObjectsToResolve)
+{
+	std::atomic<int32> ResolvedDelegatesCounter(0);
+
+	int32 FirstObjectIndex = GUObjectArray.GetFirstGCIndex();
+	int32 LastObjectIndex = GUObjectArray.GetObjectArrayNum();
+	int32 Threads = FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads());
+
+	FDelegateResolvingData* First = ObjectsToResolve.GetData();
+	FDelegateResolvingData* Last = First + ObjectsToResolve.Num();
+	auto GetObject = [&] (size_t Index)
+	{
+		return FResolvingObject{ GUObjectArray.IndexToObjectUnsafeForGC(static_cast<int32>(Index)), ResolvedDelegatesCounter };
+	};
+	auto IsDone = [&] { return ResolvedDelegatesCounter.load(std::memory_order_relaxed) == ObjectsToResolve.Num(); };
+
+	// Iterate over all objects in parallel way
+	// ObjectsToResolve doesn't need any synchronization: there are no intersections between threads
+	// All threads are processing different UObject sets
+	ParallelFor(Threads, [&] (int32 Id)
+	{
+		std::pair<size_t, size_t> Chunk = DynamicLambdaCore::GetChunk(FirstObjectIndex, LastObjectIndex, Threads, Id);
+		DynamicLambdaCore::ResolveObjects(Chunk.first, Chunk.second, First, Last, GetDelegatePointer, GetObject, IsDone);
+	});
 }
 
 bool FDynamicLambdaManager::IsTheSameDelegate(const void* Pointer, FProperty* Property, const FDelegateResolvingData& ObjectToResolve)
 {
-	if (ObjectToResolve.DelegateData.IsMulticast && Property->IsA<FMulticastDelegateProperty>())
+	if (ObjectToResolve.DelegateData.Kind == EDynamicDelegateKind::Multicast && Property->IsA<FMulticastDelegateProperty>())
 	{
 		const FMulticastScriptDelegate* Delegate = static_cast<const FMulticastScriptDelegate*>(Pointer);
 		return Delegate->Contains(ObjectToResolve.LambdaOwner.Get(), ObjectToResolve.LambdaName);
 	}
 	
-	if (!ObjectToResolve.DelegateData.IsMulticast && Property->IsA<FDelegateProperty>())
+	if (ObjectToResolve.DelegateData.Kind == EDynamicDelegateKind::Single && Property->IsA<FDelegateProperty>())
 	{
 		const FScriptDelegate* Delegate = static_cast<const FScriptDelegate*>(Pointer);
 		return Delegate->GetUObject() == ObjectToResolve.LambdaOwner.Get() &&
@@ -261,16 +1086,11 @@ bool FDynamicLambdaManager::IsTheSameDelegate(const void* Pointer, FProperty* Pr
 	return false;
 }
 
-bool FDynamicLambdaManager::ShouldSkipObject(FUObjectItem* Item, const void* MaxDelegatePtr)
+bool FDynamicLambdaManager::ShouldSkipObject(FUObjectItem* Item)
 {
+	// Address range is already checked by DynamicLambdaCore::ResolveObjects
 	UObject* Object = static_cast<UObject*>(Item->Object);
 
-	// skip objects that located after the delegates
-	if (Object == nullptr || MaxDelegatePtr < Object)
-	{
-		return true;
-	}
-
 	// skip objects that are about to be GCed or purged
 	if (Item->HasAnyFlags(EInternalObjectFlags::PendingKill | EInternalObjectFlags::Unreachable))
 	{
@@ -289,7 +1109,9 @@ bool FDynamicLambdaManager::ShouldSkipObject(FUObjectItem* Item, const void* Max
 void FDynamicLambdaManager::CleanUpLambda(UClass* Class, FName LambdaName)
 {
 	// Remove lambda storage
-	Storage[Class].Remove(LambdaName);
+	TMap<FName, FLambdaStorage>& ClassStorage = Storage[Class];
+	RemoveFromGroup(Class, LambdaName, ClassStorage[LambdaName]);
+	ClassStorage.Remove(LambdaName);
 
 	// remove native function from class
 	auto Pred = [=] (const auto& Item) { return Item.Name == LambdaName; };
@@ -301,5 +1123,5 @@ void FDynamicLambdaManager::CleanUpLambda(UClass* Class, FName LambdaName)
 	// remove lambda's UFunction and put it to pool
 	UFunction* Function = Class->FindFunctionByName(LambdaName);
 	Class->RemoveFunctionFromFunctionMap(Function);
-	FunctionPool.Add(Function);
+	FunctionPool.Release(Function);
 }
@@ -1,7 +1,17 @@
 ﻿#pragma once
 #include <CoreMinimal.h>
+#include <type_traits>
+#include "UObject/SparseDelegate.h"
+#include "DynamicLambdaCore.h"
 #include "DynamicLambda.generated.h"
 
+// Per call site invocation profiler of lambdas, it's also switched by DynamicLambda.Profiler cvar at runtime
+#ifndef DYNAMIC_LAMBDA_PROFILER
+#define DYNAMIC_LAMBDA_PROFILER !UE_BUILD_SHIPPING
+#endif
+
+class UWorld;
+
 UCLASS()
 class UAnonymousObject : public UObject
 {
@@ -24,32 +34,128 @@ class UAnonymousObject : public UObject
 		"Dynamic Delegate must have the same size as superclass");
 };
 
+enum class EDynamicDelegateKind : uint8
+{
+	Single,
+	Multicast,
+	Sparse /* sparse dynamic multicast delegate */
+};
+
 // All delegates data needed for its owner resolving
 struct FDelegateData
 {
 	const void* Pointer; /* just a raw pointer to delegate */
-	bool IsMulticast;	 /* dynamic multicast delegate flag */
+	EDynamicDelegateKind Kind;
 };
 
-struct FLambdaStorage
+// Sparse delegate's invocation list is stored by owner and delegate name, only the concrete delegate type can remove from it
+using FSparseDelegateRemover = void (*)(void* Delegate, const UObject* LambdaOwner, FName LambdaName);
+
+// Delegate bound to lambda's router
+struct FLambdaBinding
 {
 	FDelegateData DelegateData;
 	TWeakObjectPtr<UObject> DelegateOwner;
 	TWeakObjectPtr<UObject> LambdaOwner;
-	TFunction<void()> Lambda;
 
 	bool IsValid() const { return DelegateOwner.IsValid() && LambdaOwner.IsValid(); }
 };
 
+// How router passes delegate calls to lambda
+// Lambdas have no parameters, so the calls collapsed to one invocation differ by time only
+enum class ELambdaInvokePolicy : uint8
+{
+	Immediate, /* every call invokes lambda */
+	Coalesce,  /* calls of a frame invoke lambda once at the end of frame */
+	Throttle,  /* first call invokes lambda, the rest of interval's calls invoke it once at the interval end */
+	Debounce   /* lambda is invoked once calls stop for the interval */
+};
+
+struct FLambdaBindOptions
+{
+	int32 MaxInvocations = INDEX_NONE; /* INDEX_NONE means that lambda can be invoked any number of times */
+	ELambdaInvokePolicy Policy = ELambdaInvokePolicy::Immediate;
+	double Interval = 0.0;			   /* seconds, used by throttle and debounce */
+};
+
+#if DYNAMIC_LAMBDA_PROFILER
+// Invocations of all lambdas bound at the same call site (file:line of the bind)
+struct FLambdaCallSiteStats
+{
+	FString Name;
+	uint64 Calls = 0;
+	uint64 InclusiveCycles = 0;
+};
+
+enum class ELambdaProfileSortKey : uint8
+{
+	InclusiveTime,
+	Calls,
+	AverageTime
+};
+#endif // DYNAMIC_LAMBDA_PROFILER
+
+struct FLambdaStorage
+{
+	// Router of stateless lambda is shared by all delegates bound at the same call site, other routers have one binding
+	TArray<FLambdaBinding, TInlineAllocator<1>> Bindings;
+	TFunction<void()> Lambda;
+	int32 RemainingInvocations = INDEX_NONE; /* INDEX_NONE means that lambda can be invoked any number of times */
+	bool IsReleased = false;				 /* lambda is unbound and waits for clean up */
+	bool IsShared = false;					 /* router is shared by stateless lambdas */
+
+	// Invoke policy and its pending state, collapsed calls are invoked at the end of frame
+	ELambdaInvokePolicy Policy = ELambdaInvokePolicy::Immediate;
+	bool IsPending = false;		  /* some calls are collapsed and wait for invocation */
+	double Interval = 0.0;
+	double PendingDeadline = 0.0; /* pending invocation isn't made before this time */
+	double LastInvokeTime = TNumericLimits<double>::Lowest();
+
+	uint32 GroupId = 0; /* 0 means that lambda isn't in any group */
+
+	// Shared router isn't a member of any group, it's listed by the world groups of its bindings instead
+	TArray<uint32, TInlineAllocator<1>> WorldGroupIds;
+
+	// Set for sparse delegates, all bindings of the storage have the same delegate type
+	FSparseDelegateRemover SparseDelegateRemover = nullptr;
+
+#if DYNAMIC_LAMBDA_PROFILER
+	// Found on the first profiled invocation, stats are never removed, so pointer is stable
+	FLambdaCallSiteStats* CallSiteStats = nullptr;
+#endif // DYNAMIC_LAMBDA_PROFILER
+};
+
+// Lambdas bound in a group are released together, see FDynamicLambdaGroupScope
+struct FLambdaGroupHandle
+{
+	uint32 Id = 0;
+
+	bool IsValid() const { return Id != 0; }
+};
+
+struct FLambdaGroup
+{
+	TMap<UClass*, TSet<FName>> Lambdas;		  /* grouped by class to clean up every class once */
+	TMap<UClass*, TSet<FName>> SharedLambdas; /* shared routers having the world's bindings, world groups only */
+	UWorld* World = nullptr;				  /* automatic group of lambdas owned by the world's objects */
+};
+
+// Captureless lambdas and empty functors: all copies are the same, so one copy can serve any number of delegates
+template <typename TCallable>
+struct TIsStatelessCallable
+{
+	enum { Value = std::is_empty<TCallable>::value && std::is_trivially_copyable<TCallable>::value };
+};
+
 struct FDelegateResolvingData
 {
 	FDelegateResolvingData() = default;
 	FDelegateResolvingData(const FDelegateResolvingData&) = default;
 	
-	FDelegateResolvingData(FLambdaStorage& Storage, FName InLambdaName)
-		: DelegateData(Storage.DelegateData),
-		DelegateOwnerPtr(&Storage.DelegateOwner),
-		LambdaOwner(Storage.LambdaOwner),
+	FDelegateResolvingData(FLambdaBinding& Binding, FName InLambdaName)
+		: DelegateData(Binding.DelegateData),
+		DelegateOwnerPtr(&Binding.DelegateOwner),
+		LambdaOwner(Binding.LambdaOwner),
 		LambdaName(InLambdaName)
 	{
 	}
@@ -60,6 +166,21 @@ struct FDelegateResolvingData
 	FName LambdaName;
 };
 
+// Manager's memory and time metrics, used to catch slow growth over many bind/GC cycles
+struct FDynamicLambdaStats
+{
+	int32 NumLambdas = 0;			   /* lambda storages, including released ones waiting for clean up */
+	int32 NumBindings = 0;			   /* delegates bound to lambda routers */
+	int32 NumStorageBuckets = 0;	   /* classes that have ever had lambda storage */
+	int32 NumPooledFunctions = 0;	   /* UFunctions waiting for reuse */
+	int32 NumClassNativeFunctions = 0; /* native functions (including routers) of classes having lambda storage */
+	int32 NumGroups = 0;			   /* binding groups, including world ones */
+	int32 NumMappedRouters = 0;		   /* lambda storages whose router is found in the class's function map */
+	int32 NumStaleMappedFunctions = 0; /* pooled UFunctions still found in the function map of their last class */
+	double LastPreGarbageCollectMs = 0.0;
+	double LastPostGarbageCollectMs = 0.0;
+};
+
 class FDynamicLambdaManager
 {
 public:
@@ -67,7 +188,26 @@ public:
 	~FDynamicLambdaManager();
 
 	static FDynamicLambdaManager& Get();
+	static FDynamicLambdaManager* TryGet(); /* nullptr if not created yet or already destroyed on engine exit */
 	static FName GenerateLambdaName(FAnsiStringView FileName, int32 LineNumber);
+	static FName GenerateSharedLambdaName(FAnsiStringView FileName, int32 LineNumber);
+
+	// Call site of binds without file and line, e.g. the short subscription form
+	// Every lambda expression has its own type, so its compiler generated name points to the expression
+	template <typename TCallable>
+	static FAnsiStringView GetCallSite();
+
+	// Owner of lambdas bound without UObject
+	UObject* GetAnonymousObject() const { return AnonymousObject; }
+
+	FDynamicLambdaStats GetStats() const;
+
+#if DYNAMIC_LAMBDA_PROFILER
+	// Call sites sorted by the key in descending order, call sites without invocations are skipped
+	TArray<FLambdaCallSiteStats> GetProfile(ELambdaProfileSortKey SortKey = ELambdaProfileSortKey::InclusiveTime) const;
+	void DumpProfile(int32 MaxCallSites, ELambdaProfileSortKey SortKey = ELambdaProfileSortKey::InclusiveTime) const;
+	void ResetProfile();
+#endif // DYNAMIC_LAMBDA_PROFILER
 
 	template <typename TDelegate, typename TCallable>
 	void BindLambdaToDynamicDelegate(TDelegate& Delegate, TCallable&& Callable, FAnsiStringView File, int32 Line);
@@ -75,12 +215,80 @@ public:
 	template <typename TDelegate, typename TCallable>
 	void BindWeakLambdaToDynamicDelegate(UObject* Object, TDelegate& Delegate, TCallable&& Callable, FAnsiStringView File, int32 Line);
 
+	// Lambda is unbound from delegate and released right after the first invocation
+	// Returns lambda's name, it can be passed to ReleaseLambdaIfBound with the owner's class
+	template <typename TDelegate, typename TCallable>
+	FName BindOneShotLambdaToDynamicDelegate(UObject* Object, TDelegate& Delegate, TCallable&& Callable, FAnsiStringView File, int32 Line);
+
+	// Lambda is unbound from delegate and released right after MaxInvocations invocations
+	// Storage and UFunction are returned to pools when the outermost lambda call returns, so it's safe during broadcast
+	template <typename TDelegate, typename TCallable>
+	FName BindLimitedLambdaToDynamicDelegate(UObject* Object, TDelegate& Delegate, TCallable&& Callable, int32 MaxInvocations, FAnsiStringView File, int32 Line);
+
+	// Lambda is invoked according to options: limited number of times and/or with calls collapsed by invoke policy
+	// Pending invocations of coalesced, throttled and debounced lambdas are made at the end of frame
+	template <typename TDelegate, typename TCallable>
+	FName BindLambdaWithOptions(UObject* Object, TDelegate& Delegate, TCallable&& Callable, const FLambdaBindOptions& Options, FAnsiStringView File, int32 Line);
+
+	// Makes pending invocations whose policy allows it now, the rest wait for the next flush
+	// Called at the end of every frame
+	void FlushPendingInvocations();
+
+	// Unbinds and releases lambda before its last invocation, does nothing if it's already released or cleaned up
+	void ReleaseLambdaIfBound(UClass* Class, FName LambdaName);
+
+	// Lambdas bound inside FDynamicLambdaGroupScope join the group, the rest join the group of their owner's world
+	// World's group is released on world clean up, so level's lambdas don't wait for the next GC
+	FLambdaGroupHandle CreateGroup();
+
+	// All lambdas of the group are unbound and cleaned up in one pass: routers are removed from each class at once
+	void ReleaseGroup(FLambdaGroupHandle Group);
+
 protected:
+	friend class FDynamicLambdaGroupScope;
+
+	template <typename TDelegate>
+	FName BindLambda(UObject* Object, TDelegate& Delegate, TFunction<void()>&& Lambda, const FLambdaBindOptions& Options, FAnsiStringView File, int32 Line);
+
+	template <typename TDelegate, typename TCallable>
+	void BindWeakLambda(UObject* Object, TDelegate& Delegate, TCallable&& Callable, FAnsiStringView File, int32 Line, TIntegralConstant<bool, false>);
+
+	template <typename TDelegate, typename TCallable>
+	void BindWeakLambda(UObject* Object, TDelegate& Delegate, TCallable&& Callable, FAnsiStringView File, int32 Line, TIntegralConstant<bool, true>);
+
+	template <typename TCallable, typename TDelegate>
+	FName GetSharedLambdaName(UClass* Class, FAnsiStringView File, int32 Line);
+
+	static TArray<ANSICHAR> ExtractCallSite(const ANSICHAR* Signature);
+
+	FLambdaStorage* FindLambdaStorage(UClass* Class, FName LambdaName);
+	FLambdaStorage& AddLambdaStorage(UClass* Class, FName LambdaName);
+
 	void CreateLambdaRouter(UClass* ObjectClass, FName LambdaName);
 	UFunction* CreateFunction(UClass* ObjectClass, FName Name);
 	
 	static void RouteToLambda(UObject* Context, FFrame& Stack, RESULT_DECL);
-	void StoreLambda(FName LambdaName, UObject* Object, FDelegateData DelegateData, TFunction<void()>&& Lambda);
+	void InvokeLambda(UClass* Class, FName LambdaName, FLambdaStorage& LambdaStorage);
+	bool TryDeferInvocation(UClass* Class, FName LambdaName, FLambdaStorage& LambdaStorage);
+	void OnEndFrame();
+	FLambdaStorage& StoreLambda(FName LambdaName, UObject* Object, const FLambdaBinding& Binding, TFunction<void()>&& Lambda, const FLambdaBindOptions& Options);
+	void ReleaseLambda(UClass* Class, FName LambdaName);
+	void FlushPendingReleases();
+
+	static UWorld* GetObjectWorld(UObject* Object);
+	static UWorld* GetBindingWorld(const FLambdaBinding& Binding);
+	static bool IsBoundInWorld(const FLambdaBinding& Binding, UWorld* World);
+	uint32 GetWorldGroupId(UWorld* World);
+	void AddToWorldGroup(UWorld* World, UClass* Class, FName LambdaName, FLambdaStorage& LambdaStorage);
+	void ReleaseWorldBindings(uint32 GroupId, FLambdaGroup& Group);
+	void AddToGroup(uint32 GroupId, UClass* Class, FName LambdaName, FLambdaStorage& LambdaStorage);
+	void RemoveFromWorldGroups(UClass* Class, FName LambdaName, FLambdaStorage& LambdaStorage);
+	void ForgetEmptyWorldGroup(uint32 GroupId, const FLambdaGroup& Group);
+	void RemoveFromGroup(UClass* Class, FName LambdaName, FLambdaStorage& LambdaStorage);
+	void CleanUpGroup(const FLambdaGroup& Group);
+	void CleanUpLambdas(UClass* Class, const TSet<FName>& LambdaNames);
+	void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+	static void UnbindFromDelegate(const FLambdaBinding& Binding, FName LambdaName, FSparseDelegateRemover SparseDelegateRemover);
 
 	template <typename TWeakPtr, typename RetValType, typename... ParamTypes>
 	static void BindDelegate(TBaseDynamicDelegate<TWeakPtr, RetValType, ParamTypes...>& Delegate, UObject* Object, FName LambdaName);
@@ -88,11 +296,52 @@ protected:
 	template <typename TWeakPtr, typename RetValType, typename... ParamTypes>
 	static void BindDelegate(TBaseDynamicMulticastDelegate<TWeakPtr, RetValType, ParamTypes...>& Delegate, UObject* Object, FName LambdaName);
 
+	template <typename MulticastDelegate, typename OwningClass, typename DelegateInfoClass>
+	static void BindDelegate(TSparseDynamicDelegate<MulticastDelegate, OwningClass, DelegateInfoClass>& Delegate, UObject* Object, FName LambdaName);
+
+	template <typename TWeakPtr, typename RetValType, typename... ParamTypes>
+	static bool IsBoundTo(TBaseDynamicDelegate<TWeakPtr, RetValType, ParamTypes...>& Delegate, UObject* Object, FName LambdaName);
+
+	template <typename TWeakPtr, typename RetValType, typename... ParamTypes>
+	static bool IsBoundTo(TBaseDynamicMulticastDelegate<TWeakPtr, RetValType, ParamTypes...>& Delegate, UObject* Object, FName LambdaName);
+
+	template <typename MulticastDelegate, typename OwningClass, typename DelegateInfoClass>
+	static bool IsBoundTo(TSparseDynamicDelegate<MulticastDelegate, OwningClass, DelegateInfoClass>& Delegate, UObject* Object, FName LambdaName);
+
 	template <typename TWeakPtr, typename RetValType, typename... ParamTypes>
 	static FDelegateData MakeDelegateData(TBaseDynamicDelegate<TWeakPtr, RetValType, ParamTypes...>& Delegate);
 
 	template <typename TWeakPtr, typename RetValType, typename... ParamTypes>
 	static FDelegateData MakeDelegateData(TBaseDynamicMulticastDelegate<TWeakPtr, RetValType, ParamTypes...>& Delegate);
+
+	template <typename MulticastDelegate, typename OwningClass, typename DelegateInfoClass>
+	static FDelegateData MakeDelegateData(TSparseDynamicDelegate<MulticastDelegate, OwningClass, DelegateInfoClass>& Delegate);
+
+	// Owner of regular dynamic delegates is unknown at binding time and it's resolved before GC
+	template <typename TWeakPtr, typename RetValType, typename... ParamTypes>
+	static UObject* GetDelegateOwner(TBaseDynamicDelegate<TWeakPtr, RetValType, ParamTypes...>& Delegate) { return nullptr; }
+
+	template <typename TWeakPtr, typename RetValType, typename... ParamTypes>
+	static UObject* GetDelegateOwner(TBaseDynamicMulticastDelegate<TWeakPtr, RetValType, ParamTypes...>& Delegate) { return nullptr; }
+
+	// Sparse delegate knows its offset in the owner's class, so it needs no resolving
+	template <typename MulticastDelegate, typename OwningClass, typename DelegateInfoClass>
+	static UObject* GetDelegateOwner(TSparseDynamicDelegate<MulticastDelegate, OwningClass, DelegateInfoClass>& Delegate);
+
+	template <typename TWeakPtr, typename RetValType, typename... ParamTypes>
+	static FSparseDelegateRemover GetSparseDelegateRemover(TBaseDynamicDelegate<TWeakPtr, RetValType, ParamTypes...>& Delegate) { return nullptr; }
+
+	template <typename TWeakPtr, typename RetValType, typename... ParamTypes>
+	static FSparseDelegateRemover GetSparseDelegateRemover(TBaseDynamicMulticastDelegate<TWeakPtr, RetValType, ParamTypes...>& Delegate) { return nullptr; }
+
+	template <typename MulticastDelegate, typename OwningClass, typename DelegateInfoClass>
+	static FSparseDelegateRemover GetSparseDelegateRemover(TSparseDynamicDelegate<MulticastDelegate, OwningClass, DelegateInfoClass>& Delegate);
+
+	template <typename TSparseDelegate>
+	static void RemoveFromSparseDelegate(void* Delegate, const UObject* LambdaOwner, FName LambdaName);
+
+	template <typename TDelegate>
+	static FLambdaBinding MakeBinding(TDelegate& Delegate, UObject* Object);
 	
 	void OnPreGarbageCollect();
 	void OnPostGarbageCollect();
@@ -100,22 +349,79 @@ protected:
 	using FDelegateResolvingDataItems = TArray<FDelegateResolvingData>;
 	void GatherDelegatesToResolve(FDelegateResolvingDataItems& ObjectsToResolve);
 	static void ResolveDelegates(FDelegateResolvingDataItems& ObjectsToResolve);
-	static void TryResolveDelegate(FUObjectItem* Item, FDelegateResolvingDataItems& ObjectsToResolve, std::atomic<int32>& Counter);
+	void AddResolvedToWorldGroups(const FDelegateResolvingDataItems& ResolvedDelegates);
+	struct FResolvingObject;
 	static bool IsTheSameDelegate(const void* Pointer, FProperty* Property, const FDelegateResolvingData& ObjectToResolve);
-	static bool ShouldSkipObject(FUObjectItem* Item, const void* MaxDelegatePtr);
+	static bool ShouldSkipObject(FUObjectItem* Item);
+	static const void* GetDelegatePointer(const FDelegateResolvingData& Data) { return Data.DelegateData.Pointer; }
 	void CleanUpLambda(UClass* Class, FName LambdaName);
 
 	FDelegateHandle PreGarbageCollectHandle;
 	FDelegateHandle PostGarbageCollectHandle;
 	FDelegateHandle EnginePreExitHandle;
+	FDelegateHandle EndFrameHandle;
+	FDelegateHandle WorldCleanupHandle;
 	UAnonymousObject* AnonymousObject;
 	TMap<UClass*, TMap<FName, FLambdaStorage>> Storage;
-	TArray<UFunction*> FunctionPool;
+	DynamicLambdaCore::TSlotPool<UFunction*> FunctionPool;
+
+	// Lambdas released while some router is running can't be cleaned up immediately
+	int32 RouteDepth = 0;
+	TArray<TPair<UClass*, FName>> PendingReleases;
+
+	// Lambdas having collapsed calls, they are checked at the end of every frame
+	TArray<TPair<UClass*, FName>> PendingInvocations;
+
+	TMap<uint32, FLambdaGroup> Groups;
+	TMap<UWorld*, uint32> WorldGroups;
+	TArray<FLambdaGroup> PendingGroupReleases; /* groups released while some router is running */
+	FLambdaGroupHandle CurrentGroup;		   /* set by FDynamicLambdaGroupScope */
+	uint32 LastGroupId = 0;
+
+	double LastPreGarbageCollectMs = 0.0;
+	double LastPostGarbageCollectMs = 0.0;
+
+#if DYNAMIC_LAMBDA_PROFILER
+	// Stats are never removed, so pointer is stable
+	FLambdaCallSiteStats* FindOrAddCallSiteStats(FName LambdaName);
+	TMap<FName, TUniquePtr<FLambdaCallSiteStats>> CallSiteStats;
+#endif // DYNAMIC_LAMBDA_PROFILER
+};
+
+// Lambdas bound while the scope is alive join the group instead of their world's one
+class FDynamicLambdaGroupScope
+{
+public:
+	explicit FDynamicLambdaGroupScope(FLambdaGroupHandle Group)
+		: PreviousGroup(FDynamicLambdaManager::Get().CurrentGroup)
+	{
+		FDynamicLambdaManager::Get().CurrentGroup = Group;
+	}
+
+	~FDynamicLambdaGroupScope()
+	{
+		FDynamicLambdaManager::Get().CurrentGroup = PreviousGroup;
+	}
+
+private:
+	FLambdaGroupHandle PreviousGroup;
 };
 
 // ---------------------------------------------------------------------------------------------------------------------
 // Implementation
 // ---------------------------------------------------------------------------------------------------------------------
+template <typename TCallable>
+FAnsiStringView FDynamicLambdaManager::GetCallSite()
+{
+	// Extracted once per callable type
+#if defined(_MSC_VER) && !defined(__clang__)
+	static const TArray<ANSICHAR> CallSite = ExtractCallSite(__FUNCSIG__);
+#else
+	static const TArray<ANSICHAR> CallSite = ExtractCallSite(__PRETTY_FUNCTION__);
+#endif
+	return FAnsiStringView(CallSite.GetData(), CallSite.Num());
+}
+
 template <typename TDelegate, typename TCallable>
 void FDynamicLambdaManager::BindLambdaToDynamicDelegate(TDelegate& Delegate, TCallable&& Callable, FAnsiStringView File, int32 Line)
 {
@@ -124,14 +430,102 @@ void FDynamicLambdaManager::BindLambdaToDynamicDelegate(TDelegate& Delegate, TCa
 
 template <typename TDelegate, typename TCallable>
 void FDynamicLambdaManager::BindWeakLambdaToDynamicDelegate(UObject* Object, TDelegate& Delegate, TCallable&& Callable, FAnsiStringView File, int32 Line)
+{
+	using TIsStateless = TIntegralConstant<bool, TIsStatelessCallable<typename TDecay<TCallable>::Type>::Value>;
+	BindWeakLambda(Object, Delegate, Forward<TCallable>(Callable), File, Line, TIsStateless());
+}
+
+template <typename TDelegate, typename TCallable>
+void FDynamicLambdaManager::BindWeakLambda(UObject* Object, TDelegate& Delegate, TCallable&& Callable, FAnsiStringView File, int32 Line, TIntegralConstant<bool, false>)
+{
+	BindLambda(Object, Delegate, Forward<TCallable>(Callable), FLambdaBindOptions(), File, Line);
+}
+
+template <typename TDelegate, typename TCallable>
+void FDynamicLambdaManager::BindWeakLambda(UObject* Object, TDelegate& Delegate, TCallable&& Callable, FAnsiStringView File, int32 Line, TIntegralConstant<bool, true>)
+{
+	UClass* ObjectClass = Object->GetClass();
+	FName LambdaName = GetSharedLambdaName<typename TDecay<TCallable>::Type, TDelegate>(ObjectClass, File, Line);
+
+	// The same delegate can't contain the same router twice, such lambda gets its own router
+	// Grouped lambda gets its own router too: group is released with all its routers
+	if (CurrentGroup.IsValid() || IsBoundTo(Delegate, Object, LambdaName))
+	{
+		BindLambda(Object, Delegate, Forward<TCallable>(Callable), FLambdaBindOptions(), File, Line);
+		return;
+	}
+
+	FLambdaStorage* LambdaStorage = FindLambdaStorage(ObjectClass, LambdaName);
+	if (LambdaStorage == nullptr)
+	{
+		CreateLambdaRouter(ObjectClass, LambdaName);
+		LambdaStorage = &AddLambdaStorage(ObjectClass, LambdaName);
+		LambdaStorage->Lambda = Forward<TCallable>(Callable);
+		LambdaStorage->IsShared = true;
+		LambdaStorage->SparseDelegateRemover = GetSparseDelegateRemover(Delegate);
+	}
+
+	BindDelegate(Delegate, Object, LambdaName);
+	LambdaStorage->Bindings.Add(MakeBinding(Delegate, Object));
+
+	// Shared router serves many worlds, world clean up removes only the world's bindings from it
+	AddToWorldGroup(GetBindingWorld(LambdaStorage->Bindings.Last()), ObjectClass, LambdaName, *LambdaStorage);
+}
+
+template <typename TDelegate, typename TCallable>
+FName FDynamicLambdaManager::BindOneShotLambdaToDynamicDelegate(UObject* Object, TDelegate& Delegate, TCallable&& Callable, FAnsiStringView File, int32 Line)
+{
+	return BindLimitedLambdaToDynamicDelegate(Object, Delegate, Forward<TCallable>(Callable), 1, File, Line);
+}
+
+template <typename TDelegate, typename TCallable>
+FName FDynamicLambdaManager::BindLimitedLambdaToDynamicDelegate(UObject* Object, TDelegate& Delegate, TCallable&& Callable, int32 MaxInvocations, FAnsiStringView File, int32 Line)
+{
+	FLambdaBindOptions Options;
+	Options.MaxInvocations = MaxInvocations;
+	return BindLambdaWithOptions(Object, Delegate, Forward<TCallable>(Callable), Options, File, Line);
+}
+
+template <typename TDelegate, typename TCallable>
+FName FDynamicLambdaManager::BindLambdaWithOptions(UObject* Object, TDelegate& Delegate, TCallable&& Callable, const FLambdaBindOptions& Options, FAnsiStringView File, int32 Line)
+{
+	checkf(Options.MaxInvocations == INDEX_NONE || Options.MaxInvocations > 0, TEXT("Lambda must be invocable at least once"));
+	checkf(Options.Interval >= 0.0, TEXT("Interval can't be negative"));
+
+	// Pending state lives in lambda's storage, so such lambda never shares its router
+	return BindLambda(Object, Delegate, Forward<TCallable>(Callable), Options, File, Line);
+}
+
+template <typename TDelegate>
+FName FDynamicLambdaManager::BindLambda(UObject* Object, TDelegate& Delegate, TFunction<void()>&& Lambda, const FLambdaBindOptions& Options, FAnsiStringView File, int32 Line)
 {
 	FName LambdaName = GenerateLambdaName(File, Line);
 	CreateLambdaRouter(Object->GetClass(), LambdaName);
 
 	BindDelegate(Delegate, Object, LambdaName);
 
-	TFunction<void()> Lambda = Forward<TCallable>(Callable);
-	StoreLambda(LambdaName, Object, MakeDelegateData(Delegate), MoveTemp(Lambda));
+	FLambdaStorage& LambdaStorage = StoreLambda(LambdaName, Object, MakeBinding(Delegate, Object), MoveTemp(Lambda), Options);
+	LambdaStorage.SparseDelegateRemover = GetSparseDelegateRemover(Delegate);
+
+	return LambdaName;
+}
+
+template <typename TCallable, typename TDelegate>
+FName FDynamicLambdaManager::GetSharedLambdaName(UClass* Class, FAnsiStringView File, int32 Line)
+{
+	// Every lambda expression has its own type, so the name identifies the call site even if file and line are unknown
+	// Delegate type is a part of the key: all bindings of shared storage are unbound the same way
+	// Cleaned up router leaves its UFunction in the pool under the same name and outer,
+	// so a new router of the class gets a fresh name instead of renaming another UFunction on top of it
+	static TMap<UClass*, FName> LambdaNames;
+	FName& LambdaName = LambdaNames.FindOrAdd(Class);
+	FLambdaStorage* LambdaStorage = LambdaName.IsNone() ? nullptr : FindLambdaStorage(Class, LambdaName);
+	if (LambdaStorage == nullptr || LambdaStorage->IsReleased)
+	{
+		LambdaName = GenerateSharedLambdaName(File, Line);
+	}
+
+	return LambdaName;
 }
 
 template <typename TWeakPtr, typename RetValType, typename... ParamTypes>
@@ -150,16 +544,73 @@ void FDynamicLambdaManager::BindDelegate(TBaseDynamicMulticastDelegate<TWeakPtr,
 	Delegate.Add(SingleDelegate);
 }
 
+template <typename MulticastDelegate, typename OwningClass, typename DelegateInfoClass>
+void FDynamicLambdaManager::BindDelegate(TSparseDynamicDelegate<MulticastDelegate, OwningClass, DelegateInfoClass>& Delegate, UObject* Object, FName LambdaName)
+{
+	FScriptDelegate SingleDelegate;
+	SingleDelegate.BindUFunction(Object, LambdaName);
+	Delegate.Add(SingleDelegate);
+}
+
+template <typename TWeakPtr, typename RetValType, typename... ParamTypes>
+bool FDynamicLambdaManager::IsBoundTo(TBaseDynamicDelegate<TWeakPtr, RetValType, ParamTypes...>& Delegate, UObject* Object, FName LambdaName)
+{
+	return Delegate.GetUObject() == Object && Delegate.GetFunctionName() == LambdaName;
+}
+
+template <typename TWeakPtr, typename RetValType, typename... ParamTypes>
+bool FDynamicLambdaManager::IsBoundTo(TBaseDynamicMulticastDelegate<TWeakPtr, RetValType, ParamTypes...>& Delegate, UObject* Object, FName LambdaName)
+{
+	return Delegate.Contains(Object, LambdaName);
+}
+
+template <typename MulticastDelegate, typename OwningClass, typename DelegateInfoClass>
+bool FDynamicLambdaManager::IsBoundTo(TSparseDynamicDelegate<MulticastDelegate, OwningClass, DelegateInfoClass>& Delegate, UObject* Object, FName LambdaName)
+{
+	return Delegate.Contains(Object, LambdaName);
+}
+
 template <typename TWeakPtr, typename RetValType, typename... ParamTypes>
 FDelegateData FDynamicLambdaManager::MakeDelegateData(TBaseDynamicDelegate<TWeakPtr, RetValType, ParamTypes...>& Delegate)
 {
-	return { &Delegate, false };
+	return { &Delegate, EDynamicDelegateKind::Single };
 }
 
 template <typename TWeakPtr, typename RetValType, typename... ParamTypes>
 FDelegateData FDynamicLambdaManager::MakeDelegateData(TBaseDynamicMulticastDelegate<TWeakPtr, RetValType, ParamTypes...>& Delegate)
 {
-	return { &Delegate, true };
+	return { &Delegate, EDynamicDelegateKind::Multicast };
+}
+
+template <typename MulticastDelegate, typename OwningClass, typename DelegateInfoClass>
+FDelegateData FDynamicLambdaManager::MakeDelegateData(TSparseDynamicDelegate<MulticastDelegate, OwningClass, DelegateInfoClass>& Delegate)
+{
+	return { static_cast<FSparseDelegate*>(&Delegate), EDynamicDelegateKind::Sparse };
+}
+
+template <typename MulticastDelegate, typename OwningClass, typename DelegateInfoClass>
+FSparseDelegateRemover FDynamicLambdaManager::GetSparseDelegateRemover(TSparseDynamicDelegate<MulticastDelegate, OwningClass, DelegateInfoClass>& Delegate)
+{
+	return &RemoveFromSparseDelegate<TSparseDynamicDelegate<MulticastDelegate, OwningClass, DelegateInfoClass>>;
+}
+
+template <typename TSparseDelegate>
+void FDynamicLambdaManager::RemoveFromSparseDelegate(void* Delegate, const UObject* LambdaOwner, FName LambdaName)
+{
+	// delegate pointer is stored as pointer to the base FSparseDelegate
+	static_cast<TSparseDelegate*>(static_cast<FSparseDelegate*>(Delegate))->Remove(LambdaOwner, LambdaName);
+}
+
+template <typename MulticastDelegate, typename OwningClass, typename DelegateInfoClass>
+UObject* FDynamicLambdaManager::GetDelegateOwner(TSparseDynamicDelegate<MulticastDelegate, OwningClass, DelegateInfoClass>& Delegate)
+{
+	return Delegate.GetDelegateOwner();
+}
+
+template <typename TDelegate>
+FLambdaBinding FDynamicLambdaManager::MakeBinding(TDelegate& Delegate, UObject* Object)
+{
+	return { MakeDelegateData(Delegate), GetDelegateOwner(Delegate), Object };
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -168,13 +619,101 @@ FDelegateData FDynamicLambdaManager::MakeDelegateData(TBaseDynamicMulticastDeleg
 template <typename TCallable, typename TWeakPtr, typename RetValType, typename... ParamTypes>
 void operator+=(TBaseDynamicDelegate<TWeakPtr, RetValType, ParamTypes...>& Delegate, TCallable&& Callable)
 {
-	FDynamicLambdaManager::Get().BindLambdaToDynamicDelegate(Delegate, Forward<TCallable>(Callable), "unknown", 0);
+	FDynamicLambdaManager::Get().BindLambdaToDynamicDelegate(Delegate, Forward<TCallable>(Callable),
+		FDynamicLambdaManager::GetCallSite<typename TDecay<TCallable>::Type>(), 0);
 }
 
 template <typename TCallable, typename TWeakPtr, typename RetValType, typename... ParamTypes>
 void operator+=(TBaseDynamicMulticastDelegate<TWeakPtr, RetValType, ParamTypes...>& Delegate, TCallable&& Callable)
 {
-	FDynamicLambdaManager::Get().BindLambdaToDynamicDelegate(Delegate, Forward<TCallable>(Callable), "unknown", 0);
+	FDynamicLambdaManager::Get().BindLambdaToDynamicDelegate(Delegate, Forward<TCallable>(Callable),
+		FDynamicLambdaManager::GetCallSite<typename TDecay<TCallable>::Type>(), 0);
+}
+
+template <typename TCallable, typename MulticastDelegate, typename OwningClass, typename DelegateInfoClass>
+void operator+=(TSparseDynamicDelegate<MulticastDelegate, OwningClass, DelegateInfoClass>& Delegate, TCallable&& Callable)
+{
+	FDynamicLambdaManager::Get().BindLambdaToDynamicDelegate(Delegate, Forward<TCallable>(Callable),
+		FDynamicLambdaManager::GetCallSite<typename TDecay<TCallable>::Type>(), 0);
+}
+
+// Bind options support: Delegate += DynamicLambda::Once([&] { ... }); Delegate += DynamicLambda::Throttle(100.f, [&] { ... });
+namespace DynamicLambda
+{
+	template <typename TCallable>
+	struct TCallableWithOptions
+	{
+		TCallable Callable;
+		FLambdaBindOptions Options;
+	};
+
+	template <typename TCallable>
+	TCallableWithOptions<typename TDecay<TCallable>::Type> Times(int32 MaxInvocations, TCallable&& Callable)
+	{
+		FLambdaBindOptions Options;
+		Options.MaxInvocations = MaxInvocations;
+		return { Forward<TCallable>(Callable), Options };
+	}
+
+	template <typename TCallable>
+	TCallableWithOptions<typename TDecay<TCallable>::Type> Once(TCallable&& Callable)
+	{
+		return Times(1, Forward<TCallable>(Callable));
+	}
+
+	template <typename TCallable>
+	TCallableWithOptions<typename TDecay<TCallable>::Type> WithPolicy(ELambdaInvokePolicy Policy, float IntervalMs, TCallable&& Callable)
+	{
+		FLambdaBindOptions Options;
+		Options.Policy = Policy;
+		Options.Interval = IntervalMs / 1000.0;
+		return { Forward<TCallable>(Callable), Options };
+	}
+
+	// Calls of a frame are collapsed to one invocation at the end of frame
+	template <typename TCallable>
+	TCallableWithOptions<typename TDecay<TCallable>::Type> Coalesce(TCallable&& Callable)
+	{
+		return WithPolicy(ELambdaInvokePolicy::Coalesce, 0.f, Forward<TCallable>(Callable));
+	}
+
+	// At most one invocation per interval
+	template <typename TCallable>
+	TCallableWithOptions<typename TDecay<TCallable>::Type> Throttle(float IntervalMs, TCallable&& Callable)
+	{
+		return WithPolicy(ELambdaInvokePolicy::Throttle, IntervalMs, Forward<TCallable>(Callable));
+	}
+
+	// One invocation after calls stop for the interval
+	template <typename TCallable>
+	TCallableWithOptions<typename TDecay<TCallable>::Type> Debounce(float IntervalMs, TCallable&& Callable)
+	{
+		return WithPolicy(ELambdaInvokePolicy::Debounce, IntervalMs, Forward<TCallable>(Callable));
+	}
+}
+
+template <typename TCallable, typename TWeakPtr, typename RetValType, typename... ParamTypes>
+void operator+=(TBaseDynamicDelegate<TWeakPtr, RetValType, ParamTypes...>& Delegate, DynamicLambda::TCallableWithOptions<TCallable>&& Configured)
+{
+	FDynamicLambdaManager& Manager = FDynamicLambdaManager::Get();
+	Manager.BindLambdaWithOptions(Manager.GetAnonymousObject(), Delegate, MoveTemp(Configured.Callable), Configured.Options,
+		FDynamicLambdaManager::GetCallSite<TCallable>(), 0);
+}
+
+template <typename TCallable, typename TWeakPtr, typename RetValType, typename... ParamTypes>
+void operator+=(TBaseDynamicMulticastDelegate<TWeakPtr, RetValType, ParamTypes...>& Delegate, DynamicLambda::TCallableWithOptions<TCallable>&& Configured)
+{
+	FDynamicLambdaManager& Manager = FDynamicLambdaManager::Get();
+	Manager.BindLambdaWithOptions(Manager.GetAnonymousObject(), Delegate, MoveTemp(Configured.Callable), Configured.Options,
+		FDynamicLambdaManager::GetCallSite<TCallable>(), 0);
+}
+
+template <typename TCallable, typename MulticastDelegate, typename OwningClass, typename DelegateInfoClass>
+void operator+=(TSparseDynamicDelegate<MulticastDelegate, OwningClass, DelegateInfoClass>& Delegate, DynamicLambda::TCallableWithOptions<TCallable>&& Configured)
+{
+	FDynamicLambdaManager& Manager = FDynamicLambdaManager::Get();
+	Manager.BindLambdaWithOptions(Manager.GetAnonymousObject(), Delegate, MoveTemp(Configured.Callable), Configured.Options,
+		FDynamicLambdaManager::GetCallSite<TCallable>(), 0);
 }
 
 // python-like tuple support
@@ -188,12 +727,49 @@ template <typename TCallable, typename TWeakPtr, typename TRet, typename... TPar
 void operator+=(TBaseDynamicDelegate<TWeakPtr, TRet, TParamTypes...>& Delegate, TPair<UObject*, TCallable>&& WeakCallable)
 {
 	FDynamicLambdaManager::Get()
-		.BindWeakLambdaToDynamicDelegate(WeakCallable.Key, Delegate, MoveTemp(WeakCallable.Value), "unknown", 0);
+		.BindWeakLambdaToDynamicDelegate(WeakCallable.Key, Delegate, MoveTemp(WeakCallable.Value),
+			FDynamicLambdaManager::GetCallSite<typename TDecay<TCallable>::Type>(), 0);
 }
 
 template <typename TCallable, typename TWeakPtr, typename TRet, typename... TParamTypes>
 void operator+=(TBaseDynamicMulticastDelegate<TWeakPtr, TRet, TParamTypes...>& Delegate, TPair<UObject*, TCallable>&& WeakCallable)
 {
 	FDynamicLambdaManager::Get()
-		.BindWeakLambdaToDynamicDelegate(WeakCallable.Key, Delegate, MoveTemp(WeakCallable.Value), "unknown", 0);
+		.BindWeakLambdaToDynamicDelegate(WeakCallable.Key, Delegate, MoveTemp(WeakCallable.Value),
+			FDynamicLambdaManager::GetCallSite<typename TDecay<TCallable>::Type>(), 0);
+}
+
+template <typename TCallable, typename TWeakPtr, typename TRet, typename... TParamTypes>
+void operator+=(TBaseDynamicDelegate<TWeakPtr, TRet, TParamTypes...>& Delegate, TPair<UObject*, DynamicLambda::TCallableWithOptions<TCallable>>&& WeakCallable)
+{
+	DynamicLambda::TCallableWithOptions<TCallable>& Configured = WeakCallable.Value;
+	FDynamicLambdaManager::Get()
+		.BindLambdaWithOptions(WeakCallable.Key, Delegate, MoveTemp(Configured.Callable), Configured.Options,
+			FDynamicLambdaManager::GetCallSite<TCallable>(), 0);
+}
+
+template <typename TCallable, typename TWeakPtr, typename TRet, typename... TParamTypes>
+void operator+=(TBaseDynamicMulticastDelegate<TWeakPtr, TRet, TParamTypes...>& Delegate, TPair<UObject*, DynamicLambda::TCallableWithOptions<TCallable>>&& WeakCallable)
+{
+	DynamicLambda::TCallableWithOptions<TCallable>& Configured = WeakCallable.Value;
+	FDynamicLambdaManager::Get()
+		.BindLambdaWithOptions(WeakCallable.Key, Delegate, MoveTemp(Configured.Callable), Configured.Options,
+			FDynamicLambdaManager::GetCallSite<TCallable>(), 0);
+}
+
+template <typename TCallable, typename MulticastDelegate, typename OwningClass, typename DelegateInfoClass>
+void operator+=(TSparseDynamicDelegate<MulticastDelegate, OwningClass, DelegateInfoClass>& Delegate, TPair<UObject*, TCallable>&& WeakCallable)
+{
+	FDynamicLambdaManager::Get()
+		.BindWeakLambdaToDynamicDelegate(WeakCallable.Key, Delegate, MoveTemp(WeakCallable.Value),
+			FDynamicLambdaManager::GetCallSite<typename TDecay<TCallable>::Type>(), 0);
+}
+
+template <typename TCallable, typename MulticastDelegate, typename OwningClass, typename DelegateInfoClass>
+void operator+=(TSparseDynamicDelegate<MulticastDelegate, OwningClass, DelegateInfoClass>& Delegate, TPair<UObject*, DynamicLambda::TCallableWithOptions<TCallable>>&& WeakCallable)
+{
+	DynamicLambda::TCallableWithOptions<TCallable>& Configured = WeakCallable.Value;
+	FDynamicLambdaManager::Get()
+		.BindLambdaWithOptions(WeakCallable.Key, Delegate, MoveTemp(Configured.Callable), Configured.Options,
+			FDynamicLambdaManager::GetCallSite<TCallable>(), 0);
 }
@@ -0,0 +1,171 @@
+﻿#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+// Engine independent part of the dynamic lambda manager
+// Resolving and storage algorithms work with raw addresses only, so they can be compiled, benchmarked and fuzzed
+// without Unreal Engine (see Standalone folder). Everything engine specific stays in FDynamicLambdaManager
+namespace DynamicLambdaCore
+{
+	// Sort delegates to resolve by address: it allows skipping objects located after the last delegate
+	// and finding delegates of an object with binary search
+	template <typename TIterator, typename TProjection>
+	void SortByAddress(TIterator First, TIterator Last, TProjection Projection)
+	{
+		std::sort(First, Last, [&] (const auto& Lhs, const auto& Rhs)
+		{
+			return Projection(Lhs) < Projection(Rhs);
+		});
+	}
+
+	// Object can own a delegate only if the delegate lies inside [Object, Object + ObjectSize)
+	inline bool CanContainAny(const void* Object, size_t ObjectSize, const void* MinDelegatePtr, const void* MaxDelegatePtr)
+	{
+		const char* ObjectBegin = static_cast<const char*>(Object);
+		return ObjectBegin <= MaxDelegatePtr && MinDelegatePtr < ObjectBegin + ObjectSize;
+	}
+
+	// Returns range of sorted delegates located inside [Object, Object + ObjectSize)
+	// Usually it's empty, so the object's properties needn't be iterated at all
+	template <typename TIterator, typename TProjection>
+	std::pair<TIterator, TIterator> FindDelegatesInObject(TIterator First, TIterator Last, const void* Object, size_t ObjectSize, TProjection Projection)
+	{
+		const char* ObjectBegin = static_cast<const char*>(Object);
+		const char* ObjectEnd = ObjectBegin + ObjectSize;
+
+		TIterator Lower = std::lower_bound(First, Last, ObjectBegin, [&] (const auto& Item, const char* Address)
+		{
+			return static_cast<const char*>(Projection(Item)) < Address;
+		});
+		TIterator Upper = std::lower_bound(Lower, Last, ObjectEnd, [&] (const auto& Item, const char* Address)
+		{
+			return static_cast<const char*>(Projection(Item)) < Address;
+		});
+
+		return { Lower, Upper };
+	}
+
+	// Offset of the delegate relative to the object's beginning, compared with property offsets
+	inline ptrdiff_t GetDelegateOffset(const void* Object, const void* Delegate)
+	{
+		return static_cast<const char*>(Delegate) - static_cast<const char*>(Object);
+	}
+
+	// Objects [FirstObject, LastObject) are split into NumChunks contiguous ranges, one per resolving thread
+	inline std::pair<size_t, size_t> GetChunk(size_t FirstObject, size_t LastObject, size_t NumChunks, size_t Chunk)
+	{
+		size_t ObjectsPerChunk = (LastObject - FirstObject) / NumChunks + 1;
+		size_t ChunkBegin = std::min(LastObject, FirstObject + Chunk * ObjectsPerChunk);
+		size_t ChunkEnd = Chunk + 1 == NumChunks ? LastObject : std::min(LastObject, ChunkBegin + ObjectsPerChunk);
+		return { ChunkBegin, ChunkEnd };
+	}
+
+	// Resolving sees an object of the object array through an adapter:
+	//   const void* GetAddress() const;             /* nullptr for an empty slot */
+	//   size_t GetSize() const;
+	//   bool ShouldSkip() const;                    /* object can't own delegates, e.g. it's about to be destroyed */
+	//   void ForEachProperty(TVisitor&&) const;     /* calls Visitor(Offset, Property) for every property */
+	//   bool TryResolve(TItem&, const TProperty&) const; /* checks the property is the item's delegate and stores the owner */
+
+	// Matches sorted delegates located inside the object with its properties, returns number of resolved delegates
+	template <typename TIterator, typename TProjection, typename TObject>
+	size_t ResolveInObject(TIterator First, TIterator Last, TProjection Projection, const TObject& Object)
+	{
+		const void* Address = Object.GetAddress();
+		auto Candidates = FindDelegatesInObject(First, Last, Address, Object.GetSize(), Projection);
+		if (Candidates.first == Candidates.second)
+		{
+			return 0;
+		}
+
+		size_t Resolved = 0;
+		Object.ForEachProperty([&] (ptrdiff_t Offset, const auto& Property)
+		{
+			for (TIterator Item = Candidates.first; Item != Candidates.second; ++Item)
+			{
+				if (GetDelegateOffset(Address, Projection(*Item)) == Offset && Object.TryResolve(*Item, Property))
+				{
+					++Resolved;
+				}
+			}
+		});
+
+		return Resolved;
+	}
+
+	// Resolves delegates sorted by address against objects [FirstObject, LastObject), returns number of resolved delegates
+	// GetObject(Index) makes the object's adapter. IsDone() is checked before every object,
+	// so parallel callers can stop as soon as all delegates are resolved by any thread
+	template <typename TIterator, typename TProjection, typename TGetObject, typename TIsDone>
+	size_t ResolveObjects(size_t FirstObject, size_t LastObject, TIterator First, TIterator Last, TProjection Projection, TGetObject GetObject, TIsDone IsDone)
+	{
+		if (First == Last)
+		{
+			return 0;
+		}
+
+		const void* MinDelegatePtr = Projection(*First);
+		const void* MaxDelegatePtr = Projection(*std::prev(Last));
+		size_t Resolved = 0;
+		for (size_t Index = FirstObject; Index != LastObject && !IsDone(); ++Index)
+		{
+			const auto Object = GetObject(Index);
+			const void* Address = Object.GetAddress();
+
+			// Objects located after the delegates are rejected without touching their memory
+			if (Address == nullptr || MaxDelegatePtr < Address)
+			{
+				continue;
+			}
+
+			if (!CanContainAny(Address, Object.GetSize(), MinDelegatePtr, MaxDelegatePtr) || Object.ShouldSkip())
+			{
+				continue;
+			}
+
+			Resolved += ResolveInObject(First, Last, Projection, Object);
+		}
+
+		return Resolved;
+	}
+
+	// LIFO pool of free slots: the most recently released slot is reused first while it's still hot in cache
+	template <typename TSlot>
+	class TSlotPool
+	{
+	public:
+		bool IsEmpty() const { return Slots.empty(); }
+		size_t Num() const { return Slots.size(); }
+		size_t Peak() const { return PeakNum; }
+
+		template <typename TVisitor>
+		void ForEach(TVisitor Visitor) const
+		{
+			for (const TSlot& Slot : Slots)
+			{
+				Visitor(Slot);
+			}
+		}
+
+		void Release(TSlot Slot)
+		{
+			Slots.push_back(std::move(Slot));
+			PeakNum = std::max(PeakNum, Slots.size());
+		}
+
+		TSlot Acquire()
+		{
+			TSlot Slot = std::move(Slots.back());
+			Slots.pop_back();
+			return Slot;
+		}
+
+	private:
+		std::vector<TSlot> Slots;
+		size_t PeakNum = 0;
+	};
+}
@@ -0,0 +1,71 @@
+﻿#pragma once
+#include "DynamicLambda.h"
+
+// C++20 coroutine support: co_await dynamic delegate to suspend until its next execution or broadcast
+// Only available when the module is compiled with coroutines enabled
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#define WITH_DYNAMIC_LAMBDA_COROUTINES 1
+#else
+#define WITH_DYNAMIC_LAMBDA_COROUTINES 0
+#endif
+
+#if WITH_DYNAMIC_LAMBDA_COROUTINES
+#include <coroutine>
+
+// Awaiter binds one-shot lambda that resumes the coroutine, lambda's storage and UFunction are released right after
+// The awaiter lives in the coroutine frame: if the frame is destroyed while suspended, the lambda is released with it
+// If delegate is never fired (or lambda owner dies), the coroutine stays suspended
+template <typename TDelegate>
+class TDynamicDelegateAwaiter
+{
+public:
+	TDynamicDelegateAwaiter(UObject* InObject, TDelegate& InDelegate, FAnsiStringView InFile, int32 InLine)
+		: Object(InObject), Delegate(InDelegate), File(InFile), Line(InLine)
+	{
+	}
+
+	bool await_ready() const noexcept { return false; }
+	void await_resume() const noexcept {}
+
+	~TDynamicDelegateAwaiter()
+	{
+		// Fired lambda is already released, otherwise it must not resume the destroyed frame
+		// Frame destroyed after engine exit has nothing to release: the manager is gone with all lambdas
+		FDynamicLambdaManager* Manager = FDynamicLambdaManager::TryGet();
+		if (!LambdaName.IsNone() && Manager != nullptr)
+		{
+			Manager->ReleaseLambdaIfBound(LambdaClass, LambdaName);
+		}
+	}
+
+	void await_suspend(std::coroutine_handle<> Handle)
+	{
+		checkf(Object != nullptr, TEXT("Awaited delegate needs lambda owner"));
+		LambdaClass = Object->GetClass();
+		LambdaName = FDynamicLambdaManager::Get().BindOneShotLambdaToDynamicDelegate(Object, Delegate, [Handle] { Handle.resume(); }, File, Line);
+	}
+
+private:
+	UObject* Object;
+	TDelegate& Delegate;
+	FAnsiStringView File;
+	int32 Line;
+	UClass* LambdaClass = nullptr;
+	FName LambdaName;
+};
+
+// co_await NextBroadcast(Object->OnDone);
+template <typename TDelegate>
+TDynamicDelegateAwaiter<TDelegate> NextBroadcast(TDelegate& Delegate, FAnsiStringView File = "unknown", int32 Line = 0)
+{
+	return { FDynamicLambdaManager::Get().GetAnonymousObject(), Delegate, File, Line };
+}
+
+// co_await NextBroadcast(this, Object->OnDone); coroutine is never resumed if the weak owner dies before broadcast
+template <typename TDelegate>
+TDynamicDelegateAwaiter<TDelegate> NextBroadcast(UObject* Object, TDelegate& Delegate, FAnsiStringView File = "unknown", int32 Line = 0)
+{
+	return { Object, Delegate, File, Line };
+}
+
+#endif // WITH_DYNAMIC_LAMBDA_COROUTINES
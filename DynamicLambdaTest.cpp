@@ -1,5 +1,8 @@
 ﻿#include "DynamicLambdaTest.h"
 #include "DynamicLambda.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/StrongObjectPtr.h"
 
 #if WITH_DEV_AUTOMATION_TESTS
 
@@ -26,6 +29,73 @@ namespace DynamicLambdaTestInternals
 		void operator()() const {};
 		int32& CountRef;
 	};
+
+	TAutoConsoleVariable<int32> CVarSoakIterations(
+		TEXT("DynamicLambda.Soak.Iterations"),
+		200,
+		TEXT("Number of GC cycles in DynamicLambda GCChurnSoak test"));
+
+	TAutoConsoleVariable<int32> CVarSoakOperations(
+		TEXT("DynamicLambda.Soak.OperationsPerIteration"),
+		256,
+		TEXT("Number of random bind/fire/unbind/kill operations between GC cycles in DynamicLambda GCChurnSoak test"));
+
+	int32 GetNumNames()
+	{
+		return FName::GetNumAnsiNames() + FName::GetNumWideNames();
+	}
+
+	double GetPercentile(TArray<double> Values, double Percentile)
+	{
+		Values.Sort();
+		int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * Values.Num()) - 1, 0, Values.Num() - 1);
+		return Values[Index];
+	}
+
+#if WITH_DYNAMIC_LAMBDA_COROUTINES
+	// Minimal eagerly started coroutine without result
+	struct FFireAndForget
+	{
+		struct promise_type
+		{
+			FFireAndForget get_return_object() { return {}; }
+			std::suspend_never initial_suspend() noexcept { return {}; }
+			std::suspend_never final_suspend() noexcept { return {}; }
+			void return_void() {}
+			void unhandled_exception() {}
+		};
+	};
+
+	FFireAndForget WaitForTwoBroadcasts(UDynamicLambdaTest* Test, int32* Step)
+	{
+		*Step = 1;
+		co_await NextBroadcast(Test->SimpleTestMulticastDelegate, __FILE__, __LINE__);
+		*Step = 2;
+		co_await NextBroadcast(Test->SimpleTestMulticastDelegate, __FILE__, __LINE__);
+		*Step = 3;
+	}
+
+	// Coroutine that can be destroyed while it's suspended
+	struct FDestroyableTask
+	{
+		struct promise_type
+		{
+			FDestroyableTask get_return_object() { return { std::coroutine_handle<promise_type>::from_promise(*this) }; }
+			std::suspend_never initial_suspend() noexcept { return {}; }
+			std::suspend_always final_suspend() noexcept { return {}; }
+			void return_void() {}
+			void unhandled_exception() {}
+		};
+
+		std::coroutine_handle<promise_type> Handle;
+	};
+
+	FDestroyableTask WaitForBroadcast(UDynamicLambdaTest* Test, int32* Step)
+	{
+		co_await NextBroadcast(Test->SimpleTestMulticastDelegate, __FILE__, __LINE__);
+		*Step = 1;
+	}
+#endif // WITH_DYNAMIC_LAMBDA_COROUTINES
 }
 
 FDynamicLambdaTestBase::FDynamicLambdaTestBase(const FString& InName, const bool bInComplexTask)
@@ -280,4 +350,643 @@ bool FUFunctionsReusedAfterAfterGC::RunTest(const FString& Parameters)
 	return FuncName != NewFuncName && Function == NewFunction && LambdaInvoked;
 }
 
+// One-shot lambda is unbound and destroyed right after the first invocation, its UFunction goes to pool
+bool FOneShotLambdaIsReleasedAfterInvocation::RunTest(const FString& Parameters)
+{
+	UDynamicLambdaTest* Test = NewObject<UDynamicLambdaTest>();
+	UDummy* DummyObj = NewObject<UDummy>();
+	UClass* DummyClass = DummyObj->GetClass();
+	int32 NativeFunctionsNum = DummyClass->NativeFunctionLookupTable.Num();
+	int32 AliveCount = 0;
+	int32 InvocationCounter = 0;
+
+	Test->SimpleTestMulticastDelegate += (DummyObj, DynamicLambda::Once(DynamicLambdaTestInternals::FAliveTestFunctor(AliveCount)));
+	Test->SimpleTestMulticastDelegate += DynamicLambda::Once([&] { InvocationCounter++; });
+	TestEqual("Router is created", DummyClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum + 1);
+	TestEqual("Lambda lives", AliveCount, 1);
+
+	Test->SimpleTestMulticastDelegate.Broadcast();
+	Test->SimpleTestMulticastDelegate.Broadcast();
+
+	TestEqual("Lambda invoked once", InvocationCounter, 1);
+	TestEqual("Lambda is destroyed without GC", AliveCount, 0);
+	TestEqual("Router is released without GC", DummyClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum);
+	TestFalse("Delegate is unbound", Test->SimpleTestMulticastDelegate.IsBound());
+
+	return InvocationCounter == 1 && AliveCount == 0;
+}
+
+bool FLimitedLambdaIsReleasedAfterLastInvocation::RunTest(const FString& Parameters)
+{
+	UDynamicLambdaTest* Test = NewObject<UDynamicLambdaTest>();
+	int32 InvocationCounter = 0;
+
+	Test->SimpleTestDelegate += DynamicLambda::Times(3, [&] { InvocationCounter++; });
+	for (int32 Idx = 0; Idx != 5; ++Idx)
+	{
+		Test->SimpleTestDelegate.ExecuteIfBound();
+	}
+
+	TestEqual("Lambda invoked three times", InvocationCounter, 3);
+	TestFalse("Delegate is unbound", Test->SimpleTestDelegate.IsBound());
+
+	return InvocationCounter == 3;
+}
+
+// Limited lambdas are released while the delegate is broadcast: from nested broadcast and with rebinding
+bool FLimitedLambdasAreReleasedDuringBroadcast::RunTest(const FString& Parameters)
+{
+	UDynamicLambdaTest* Test = NewObject<UDynamicLambdaTest>();
+	UClass* AnonymousClass = FDynamicLambdaManager::Get().GetAnonymousObject()->GetClass();
+	int32 NativeFunctionsNum = AnonymousClass->NativeFunctionLookupTable.Num();
+	int32 NestedCounter = 0;
+	int32 RebindCounter = 0;
+	int32 PermanentCounter = 0;
+
+	FSimpleTestMulticastDelegate& Delegate = Test->SimpleTestMulticastDelegate;
+	Delegate += DynamicLambda::Once([&] { NestedCounter++; Delegate.Broadcast(); });
+	Delegate += DynamicLambda::Once([&]
+	{
+		RebindCounter++;
+		Delegate += DynamicLambda::Once([&] { RebindCounter++; });
+	});
+	Delegate += [&] { PermanentCounter++; };
+
+	Delegate.Broadcast();
+	TestEqual("Nested broadcast doesn't invoke released lambda again", NestedCounter, 1);
+	TestEqual("Rebound lambda isn't invoked during the same broadcast", RebindCounter, 1);
+	TestEqual("Permanent lambda is invoked by both broadcasts", PermanentCounter, 2);
+	TestEqual("Routers of invoked lambdas are released", AnonymousClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum + 2);
+
+	Delegate.Broadcast();
+	TestEqual("Rebound lambda is invoked once", RebindCounter, 2);
+	TestEqual("Permanent lambda is invoked", PermanentCounter, 3);
+	TestEqual("Only permanent router is left", AnonymousClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum + 1);
+
+	return NestedCounter == 1 && RebindCounter == 2 && PermanentCounter == 3;
+}
+
+// Captureless lambda bound in a loop creates the only router, it's released when the last delegate owner dies
+bool FStatelessLambdasShareRouter::RunTest(const FString& Parameters)
+{
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, false);
+
+	static int32 InvocationCounter;
+	InvocationCounter = 0;
+
+	TArray<UDynamicLambdaTest*> TestObjects = MakeTestObjects(5);
+	UDummy* DummyObj = NewObject<UDummy>();
+	UClass* DummyClass = DummyObj->GetClass();
+	int32 NativeFunctionsNum = DummyClass->NativeFunctionLookupTable.Num();
+
+	// the first delegate is bound twice: delegate can't contain the same router twice, so it gets its own router
+	TArray<UDynamicLambdaTest*> Targets = TestObjects;
+	Targets.Add(TestObjects[0]);
+	for (UDynamicLambdaTest* Target : Targets)
+	{
+		Target->SimpleTestMulticastDelegate += (DummyObj, [] { InvocationCounter++; });
+	}
+	TestEqual("Stateless lambdas share the router", DummyClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum + 2);
+
+	for (UDynamicLambdaTest* TestObject : TestObjects)
+	{
+		TestObject->SimpleTestMulticastDelegate.Broadcast();
+	}
+	TestEqual("Every delegate invokes the shared lambda", InvocationCounter, TestObjects.Num() + 1);
+
+	DummyObj->AddToRoot();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, false);
+	DummyObj->RemoveFromRoot();
+	TestEqual("Shared router is released with the last delegate", DummyClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum);
+
+	return InvocationCounter == TestObjects.Num() + 1;
+}
+
+// Shared router released by GC is created again under a fresh name: its old UFunction is still in the pool
+bool FSharedRouterIsRecreatedAfterGC::RunTest(const FString& Parameters)
+{
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, false);
+
+	static int32 InvocationCounter;
+	InvocationCounter = 0;
+
+	// the same lambda expression, so the same callable type for every bind
+	auto BindStateless = [] (UObject* Owner, UDynamicLambdaTest* Target)
+	{
+		Target->SimpleTestMulticastDelegate += (Owner, [] { InvocationCounter++; });
+	};
+
+	UDummy* DummyObj = NewObject<UDummy>();
+	UClass* DummyClass = DummyObj->GetClass();
+	int32 NativeFunctionsNum = DummyClass->NativeFunctionLookupTable.Num();
+
+	BindStateless(DummyObj, NewObject<UDynamicLambdaTest>());
+	DummyObj->AddToRoot();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, false);
+	TestEqual("Shared router is released", DummyClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum);
+
+	// another router of the class goes to the top of the pool, so it's reused by the next router
+	UDynamicLambdaTest* Test = NewObject<UDynamicLambdaTest>();
+	int32 OneShotCounter = 0;
+	Test->SimpleTestDelegate += (DummyObj, DynamicLambda::Once([&] { OneShotCounter++; }));
+	Test->SimpleTestDelegate.ExecuteIfBound();
+
+	BindStateless(DummyObj, Test);
+	Test->SimpleTestMulticastDelegate.Broadcast();
+	DummyObj->RemoveFromRoot();
+
+	TestEqual("Shared router is created again", DummyClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum + 1);
+	TestEqual("Lambda is invoked by new router", InvocationCounter, 1);
+
+	return InvocationCounter == 1;
+}
+
+// All subscription forms work with sparse delegates
+bool FBoundToSparseDelegateLambdaInvoking::RunTest(const FString& Parameters)
+{
+	UDynamicLambdaTest* Test = NewObject<UDynamicLambdaTest>();
+	UDynamicLambdaReceiverTest* ReceiverTest = NewObject<UDynamicLambdaReceiverTest>();
+	int32 InvocationCounter = 0;
+	int32 OnceCounter = 0;
+
+	Test->SimpleTestSparseDelegate += [&] { InvocationCounter++; };
+	Test->SimpleTestSparseDelegate += (ReceiverTest, [&] { InvocationCounter++; });
+	Test->SimpleTestSparseDelegate += DynamicLambda::Once([&] { OnceCounter++; });
+	TestTrue("Sparse delegate bound", Test->SimpleTestSparseDelegate.IsBound());
+
+	Test->SimpleTestSparseDelegate.Broadcast();
+	Test->SimpleTestSparseDelegate.Broadcast();
+
+	TestEqual("Lambdas invoked on every broadcast", InvocationCounter, 4);
+	TestEqual("One-shot lambda invoked once", OnceCounter, 1);
+
+	return InvocationCounter == 4 && OnceCounter == 1;
+}
+
+// Sparse delegate's owner is known at binding time: lambda dies with it on the next GC
+bool FSparseDelegateLambdaIsDestroyedAfterOwnerDestroy::RunTest(const FString& Parameters)
+{
+	int32 AliveCount = 0;
+
+	TWeakObjectPtr<UDynamicLambdaTest> Test = NewObject<UDynamicLambdaTest>();
+	Test->SimpleTestSparseDelegate += DynamicLambdaTestInternals::FAliveTestFunctor(AliveCount);
+	TestEqual("Lambda lives", AliveCount, 1);
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, false);
+	TestFalse("Object is dead after GC", Test.IsValid());
+	TestEqual("Lambda was freed", AliveCount, 0);
+
+	return AliveCount == 0;
+}
+
+// Coalesced, throttled and debounced lambdas collapse calls to one invocation, pending ones are made at the end of frame
+bool FInvokePoliciesCollapseCalls::RunTest(const FString& Parameters)
+{
+	FDynamicLambdaManager& Manager = FDynamicLambdaManager::Get();
+	UDynamicLambdaTest* Test = NewObject<UDynamicLambdaTest>();
+	UDummy* DummyObj = NewObject<UDummy>();
+	int32 CoalesceCounter = 0;
+	int32 ThrottleCounter = 0;
+	int32 DebounceCounter = 0;
+	int32 LongDebounceCounter = 0;
+
+	// lambdas waiting for long intervals die with the dummy, so they are never invoked after the test
+	FSimpleTestMulticastDelegate& Delegate = Test->SimpleTestMulticastDelegate;
+	Delegate += DynamicLambda::Coalesce([&] { CoalesceCounter++; });
+	Delegate += DynamicLambda::Debounce(0.f, [&] { DebounceCounter++; });
+	Delegate += (DummyObj, DynamicLambda::Throttle(1000000.f, [&] { ThrottleCounter++; }));
+	Delegate += (DummyObj, DynamicLambda::Debounce(1000000.f, [&] { LongDebounceCounter++; }));
+
+	for (int32 Idx = 0; Idx != 5; ++Idx)
+	{
+		Delegate.Broadcast();
+	}
+	TestEqual("Coalesced calls wait for the end of frame", CoalesceCounter, 0);
+	TestEqual("Debounced calls wait for the end of frame", DebounceCounter, 0);
+	TestEqual("The first throttled call is invoked immediately", ThrottleCounter, 1);
+
+	Manager.FlushPendingInvocations();
+	TestEqual("Coalesced calls are invoked once", CoalesceCounter, 1);
+	TestEqual("Debounced calls are invoked once", DebounceCounter, 1);
+	TestEqual("Throttled calls wait for the interval end", ThrottleCounter, 1);
+	TestEqual("Debounced calls wait for the interval end", LongDebounceCounter, 0);
+
+	Manager.FlushPendingInvocations();
+	TestEqual("Nothing is pending after invocation", CoalesceCounter + DebounceCounter, 2);
+
+	DummyObj->MarkPendingKill();
+	Manager.FlushPendingInvocations();
+	TestEqual("Pending calls of dead owner are dropped", ThrottleCounter + LongDebounceCounter, 1);
+
+	// anonymous lambda's owner is always alive, so its delegate owner is checked (sparse one is known at binding time)
+	UDynamicLambdaTest* DyingTest = NewObject<UDynamicLambdaTest>();
+	int32 DyingCounter = 0;
+	DyingTest->SimpleTestSparseDelegate += DynamicLambda::Coalesce([&] { DyingCounter++; });
+	DyingTest->SimpleTestSparseDelegate.Broadcast();
+	DyingTest->MarkPendingKill();
+	Manager.FlushPendingInvocations();
+	TestEqual("Pending calls of dead delegate owner are dropped", DyingCounter, 0);
+
+	return CoalesceCounter == 1 && DebounceCounter == 1 && ThrottleCounter == 1 && LongDebounceCounter == 0 && DyingCounter == 0;
+}
+
+// Lambdas bound inside the group scope are unbound and their routers are removed by one release
+bool FGroupLambdasAreReleasedTogether::RunTest(const FString& Parameters)
+{
+	FDynamicLambdaManager& Manager = FDynamicLambdaManager::Get();
+	UClass* AnonymousClass = Manager.GetAnonymousObject()->GetClass();
+	int32 NativeFunctionsNum = AnonymousClass->NativeFunctionLookupTable.Num();
+	TArray<UDynamicLambdaTest*> TestObjects = MakeTestObjects(3);
+	int32 GroupCounter = 0;
+	int32 OutsideCounter = 0;
+
+	FLambdaGroupHandle Group = Manager.CreateGroup();
+	{
+		FDynamicLambdaGroupScope GroupScope(Group);
+		for (UDynamicLambdaTest* TestObject : TestObjects)
+		{
+			TestObject->SimpleTestDelegate += [&] { GroupCounter++; };
+			TestObject->SimpleTestMulticastDelegate += [&] { GroupCounter++; };
+		}
+	}
+	TestObjects[0]->SimpleTestMulticastDelegate += [&] { OutsideCounter++; };
+	TestEqual("Every lambda has router", AnonymousClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum + 7);
+
+	Manager.ReleaseGroup(Group);
+	for (UDynamicLambdaTest* TestObject : TestObjects)
+	{
+		TestFalse("Delegate is unbound", TestObject->SimpleTestDelegate.IsBound());
+		TestObject->SimpleTestMulticastDelegate.Broadcast();
+	}
+	TestEqual("Group's lambdas aren't invoked", GroupCounter, 0);
+	TestEqual("Lambda bound outside the scope is invoked", OutsideCounter, 1);
+	TestEqual("Group's routers are released", AnonymousClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum + 1);
+
+	return GroupCounter == 0 && OutsideCounter == 1;
+}
+
+// Lambda bound in the scope of a released group still belongs to its world's group
+bool FReleasedGroupScopeFallsBackToWorldGroup::RunTest(const FString& Parameters)
+{
+	FDynamicLambdaManager& Manager = FDynamicLambdaManager::Get();
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	UDynamicLambdaTest* Test = NewObject<UDynamicLambdaTest>(World);
+	UClass* TestClass = Test->GetClass();
+	int32 NativeFunctionsNum = TestClass->NativeFunctionLookupTable.Num();
+	int32 InvocationCounter = 0;
+
+	FLambdaGroupHandle Group = Manager.CreateGroup();
+	Manager.ReleaseGroup(Group);
+	{
+		FDynamicLambdaGroupScope GroupScope(Group);
+		Test->SimpleTestMulticastDelegate += (Test, [&] { InvocationCounter++; });
+	}
+	TestEqual("Lambda has router", TestClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum + 1);
+
+	Test->SimpleTestMulticastDelegate.Broadcast();
+	TestEqual("Lambda is invoked", InvocationCounter, 1);
+
+	World->DestroyWorld(false);
+	TestFalse("Delegate is unbound", Test->SimpleTestMulticastDelegate.IsBound());
+	TestEqual("Router is released with the world", TestClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum);
+
+	return InvocationCounter == 1;
+}
+
+// Lambdas owned by the world's objects don't wait for GC after the world is cleaned up
+bool FWorldLambdasAreReleasedOnWorldCleanup::RunTest(const FString& Parameters)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	UDynamicLambdaTest* Test = NewObject<UDynamicLambdaTest>(World);
+	UClass* TestClass = Test->GetClass();
+	int32 NativeFunctionsNum = TestClass->NativeFunctionLookupTable.Num();
+	int32 InvocationCounter = 0;
+
+	for (int32 Idx = 0; Idx != 3; ++Idx)
+	{
+		Test->SimpleTestMulticastDelegate += (Test, [&] { InvocationCounter++; });
+	}
+	TestEqual("Every lambda has router", TestClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum + 3);
+
+	World->DestroyWorld(false);
+	TestEqual("World's routers are released", TestClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum);
+	TestFalse("Delegate is unbound", Test->SimpleTestMulticastDelegate.IsBound());
+
+	return TestClass->NativeFunctionLookupTable.Num() == NativeFunctionsNum;
+}
+
+// Shared router of captureless lambda loses the world's bindings on world clean up and keeps serving the rest
+bool FSharedRouterLosesWorldBindingsOnWorldCleanup::RunTest(const FString& Parameters)
+{
+	static int32 InvocationCounter;
+	InvocationCounter = 0;
+
+	// the same lambda expression, so the same shared router for both objects of the class
+	auto BindStateless = [] (UDynamicLambdaTest* Target)
+	{
+		Target->SimpleTestMulticastDelegate += (Target, [] { InvocationCounter++; });
+	};
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	UDynamicLambdaTest* WorldTest = NewObject<UDynamicLambdaTest>(World);
+	UDynamicLambdaTest* OutsideTest = NewObject<UDynamicLambdaTest>();
+	UClass* TestClass = WorldTest->GetClass();
+	int32 NativeFunctionsNum = TestClass->NativeFunctionLookupTable.Num();
+
+	BindStateless(WorldTest);
+	BindStateless(OutsideTest);
+	TestEqual("Lambdas share the router", TestClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum + 1);
+
+	World->DestroyWorld(false);
+	TestFalse("World's delegate is unbound", WorldTest->SimpleTestMulticastDelegate.IsBound());
+	TestEqual("Shared router is kept for the rest of bindings", TestClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum + 1);
+
+	OutsideTest->SimpleTestMulticastDelegate.Broadcast();
+	TestEqual("Lambda is invoked by the rest of bindings", InvocationCounter, 1);
+
+	// the last binding is released with its owner, so the router too
+	OutsideTest->MarkPendingKill();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, false);
+	TestEqual("Shared router is released", TestClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum);
+
+	return InvocationCounter == 1;
+}
+
+// Shared router cleaned up by GC is forgotten by its world's group, so the group doesn't outlive its lambdas
+bool FSharedRouterCleanedUpByGCLeavesWorldGroup::RunTest(const FString& Parameters)
+{
+	FDynamicLambdaManager& Manager = FDynamicLambdaManager::Get();
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	int32 NumGroups = Manager.GetStats().NumGroups;
+
+	// every bind recreates the shared router under a fresh name
+	for (int32 Idx = 0; Idx != 3; ++Idx)
+	{
+		UDynamicLambdaTest* Test = NewObject<UDynamicLambdaTest>(World);
+		Test->SimpleTestMulticastDelegate += (Test, [] {});
+		TestEqual("World's group is created", Manager.GetStats().NumGroups, NumGroups + 1);
+
+		Test->MarkPendingKill();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, false);
+		TestEqual("Empty world's group is dropped", Manager.GetStats().NumGroups, NumGroups);
+	}
+
+	World->DestroyWorld(false);
+	return !HasAnyErrors();
+}
+
+#if DYNAMIC_LAMBDA_PROFILER
+bool FProfilerCountsInvocationsPerCallSite::RunTest(const FString& Parameters)
+{
+	IConsoleVariable* ProfilerCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("DynamicLambda.Profiler"));
+	int32 ProfilerEnabled = ProfilerCVar->GetInt();
+	ProfilerCVar->Set(1);
+
+	FDynamicLambdaManager& Manager = FDynamicLambdaManager::Get();
+	Manager.ResetProfile();
+
+	auto GetCalls = [&Manager] (const TCHAR* CallSite)
+	{
+		TArray<FLambdaCallSiteStats> Profile = Manager.GetProfile();
+		const FLambdaCallSiteStats* Stats = Profile.FindByPredicate([CallSite] (const FLambdaCallSiteStats& Item)
+		{
+			return Item.Name.Contains(CallSite);
+		});
+		return Stats != nullptr ? static_cast<int32>(Stats->Calls) : 0;
+	};
+
+	TArray<UDynamicLambdaTest*> TestObjects = MakeTestObjects(3);
+	for (UDynamicLambdaTest* TestObject : TestObjects)
+	{
+		Manager.BindLambdaToDynamicDelegate(TestObject->SimpleTestMulticastDelegate, [] {}, "FrequentSite", 1);
+	}
+	Manager.BindLambdaToDynamicDelegate(TestObjects[0]->SimpleTestDelegate, [] {}, "RareSite", 2);
+
+	for (UDynamicLambdaTest* TestObject : TestObjects)
+	{
+		TestObject->SimpleTestMulticastDelegate.Broadcast();
+		TestObject->SimpleTestMulticastDelegate.Broadcast();
+	}
+	TestObjects[0]->SimpleTestDelegate.Execute();
+
+	TestEqual("All lambdas of the call site are counted together", GetCalls(TEXT("FrequentSite:1")), 6);
+	TestEqual("Rare call site is counted", GetCalls(TEXT("RareSite:2")), 1);
+	TestTrue("Profile is sorted by calls", Manager.GetProfile(ELambdaProfileSortKey::Calls)[0].Name.Contains(TEXT("FrequentSite:1")));
+
+	// short subscription form takes the call site from the lambda expression
+	TestObjects[1]->SimpleTestDelegate += [] {};
+	TestObjects[2]->SimpleTestDelegate += [] {};
+	TestObjects[1]->SimpleTestDelegate.Execute();
+	TestObjects[2]->SimpleTestDelegate.Execute();
+	TestEqual("Lambda expressions are different call sites", Manager.GetProfile().Num(), 4);
+
+	ProfilerCVar->Set(0);
+	TestObjects[0]->SimpleTestDelegate.Execute();
+	TestEqual("Disabled profiler doesn't count", GetCalls(TEXT("RareSite:2")), 1);
+
+	ProfilerCVar->Set(ProfilerEnabled);
+	return !HasAnyErrors();
+}
+#endif // DYNAMIC_LAMBDA_PROFILER
+
+// Random bind/fire/unbind/kill churn with GC after every iteration
+// All owners are killed in the middle and at the end: manager's memory must not grow between these points
+bool FGCChurnSoak::RunTest(const FString& Parameters)
+{
+	using namespace DynamicLambdaTestInternals;
+
+	const int32 Iterations = FMath::Max(2, CVarSoakIterations.GetValueOnGameThread());
+	const int32 Operations = FMath::Max(1, CVarSoakOperations.GetValueOnGameThread());
+	const int32 MaxOwners = 64;
+	const int32 AllowedNamesGrowth = 64;
+
+	FDynamicLambdaManager& Manager = FDynamicLambdaManager::Get();
+	FRandomStream Random(1234);
+	TArray<TStrongObjectPtr<UDynamicLambdaTest>> Owners;
+	TArray<TStrongObjectPtr<UDynamicLambdaReceiverTest>> Receivers;
+	TArray<FLambdaGroupHandle> Groups;
+	TArray<double> GarbageCollectMs;
+	int32 Invocations = 0;
+
+	// captureless lambdas share routers, so they count invocations without a capture
+	static int32 SharedInvocations;
+	SharedInvocations = 0;
+
+	for (int32 Idx = 0; Idx != MaxOwners; ++Idx)
+	{
+		Owners.Emplace(NewObject<UDynamicLambdaTest>());
+		Receivers.Emplace(NewObject<UDynamicLambdaReceiverTest>());
+	}
+
+	auto KillAllAndCollect = [&]
+	{
+		for (FLambdaGroupHandle Group : Groups)
+		{
+			Manager.ReleaseGroup(Group);
+		}
+		Groups.Reset();
+
+		for (int32 Idx = 0; Idx != MaxOwners; ++Idx)
+		{
+			Owners[Idx].Reset(NewObject<UDynamicLambdaTest>());
+			Receivers[Idx].Reset(NewObject<UDynamicLambdaReceiverTest>());
+		}
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, false);
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, false);
+	};
+
+	FDynamicLambdaStats MiddleStats;
+	int32 MiddleNames = 0;
+
+	for (int32 Iteration = 0; Iteration != Iterations; ++Iteration)
+	{
+		for (int32 Operation = 0; Operation != Operations; ++Operation)
+		{
+			int32 Index = Random.RandHelper(MaxOwners);
+			UDynamicLambdaTest* Owner = Owners[Index].Get();
+			UDynamicLambdaReceiverTest* Receiver = Receivers[Index].Get();
+			switch (Random.RandHelper(12))
+			{
+			case 0:
+				Owner->SimpleTestMulticastDelegate += [&Invocations] { ++Invocations; };
+				break;
+			case 1:
+				Owner->SimpleTestDelegate += (Receiver, [&Invocations] { ++Invocations; });
+				break;
+			case 2:
+				Manager.BindOneShotLambdaToDynamicDelegate(Receiver, Owner->SimpleTestMulticastDelegate, [&Invocations]
+				{
+					++Invocations;
+				}, __FILE__, __LINE__);
+				break;
+			case 3:
+				Owner->SimpleTestMulticastDelegate.Broadcast();
+				Owner->SimpleTestSparseDelegate.Broadcast();
+				Owner->SimpleTestDelegate.ExecuteIfBound();
+				break;
+			case 4:
+				Owner->SimpleTestMulticastDelegate.Clear();
+				Owner->SimpleTestSparseDelegate.Clear();
+				Owner->SimpleTestDelegate.Unbind();
+				break;
+			case 5:
+				Owners[Index].Reset(NewObject<UDynamicLambdaTest>());
+				break;
+			case 6:
+				Receivers[Index].Reset(NewObject<UDynamicLambdaReceiverTest>());
+				break;
+			case 7:
+				Owner->SimpleTestMulticastDelegate += (Receiver, [] { ++SharedInvocations; });
+				break;
+			case 8:
+				Owner->SimpleTestSparseDelegate += (Receiver, [&Invocations] { ++Invocations; });
+				break;
+			case 9:
+				Owner->SimpleTestMulticastDelegate += (Receiver, DynamicLambda::Coalesce([&Invocations] { ++Invocations; }));
+				break;
+			case 10:
+			{
+				FDynamicLambdaGroupScope GroupScope(Groups.Add_GetRef(Manager.CreateGroup()));
+				Owner->SimpleTestMulticastDelegate += (Receiver, [&Invocations] { ++Invocations; });
+				Owner->SimpleTestSparseDelegate += (Receiver, [] { ++SharedInvocations; });
+				break;
+			}
+			case 11:
+				if (Groups.Num() != 0)
+				{
+					Manager.ReleaseGroup(Groups[0]);
+					Groups.RemoveAtSwap(0);
+				}
+				break;
+			}
+		}
+
+		// tests don't end frames, coalesced calls are made here
+		Manager.FlushPendingInvocations();
+
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, false);
+		FDynamicLambdaStats Stats = Manager.GetStats();
+		GarbageCollectMs.Add(Stats.LastPreGarbageCollectMs + Stats.LastPostGarbageCollectMs);
+
+		if (Iteration == Iterations / 2)
+		{
+			KillAllAndCollect();
+			MiddleStats = Manager.GetStats();
+			MiddleNames = GetNumNames();
+		}
+	}
+
+	KillAllAndCollect();
+	FDynamicLambdaStats FinalStats = Manager.GetStats();
+	int32 FinalNames = GetNumNames();
+
+	AddInfo(FString::Printf(TEXT("%d invocations, GC callbacks p50 %.3f ms, p99 %.3f ms"),
+		Invocations + SharedInvocations, GetPercentile(GarbageCollectMs, 0.5), GetPercentile(GarbageCollectMs, 0.99)));
+	AddInfo(FString::Printf(TEXT("Pooled UFunctions: %d -> %d, names: %d -> %d"),
+		MiddleStats.NumPooledFunctions, FinalStats.NumPooledFunctions, MiddleNames, FinalNames));
+
+	// Pool keeps the peak number of simultaneously bound routers: the second half mustn't be much worse than the first
+	int32 AllowedPooledFunctions = MiddleStats.NumPooledFunctions + FMath::Max(64, MiddleStats.NumPooledFunctions / 4);
+
+	TestTrue("Lambdas were invoked", Invocations > 0);
+	TestTrue("Shared routers were invoked", SharedInvocations > 0);
+	TestTrue("Groups don't grow", FinalStats.NumGroups <= MiddleStats.NumGroups);
+	TestTrue("Lambda storages don't grow", FinalStats.NumLambdas <= MiddleStats.NumLambdas);
+	TestTrue("Storage buckets don't grow", FinalStats.NumStorageBuckets <= MiddleStats.NumStorageBuckets);
+	TestTrue("Class native function tables don't grow", FinalStats.NumClassNativeFunctions <= MiddleStats.NumClassNativeFunctions);
+	TestEqual("Every lambda storage has its router mapped", FinalStats.NumMappedRouters, FinalStats.NumLambdas);
+	TestEqual("Pooled functions are removed from function maps", FinalStats.NumStaleMappedFunctions, 0);
+	TestTrue("Function pool is bounded", FinalStats.NumPooledFunctions <= AllowedPooledFunctions);
+	TestTrue("Name table is bounded", FinalNames - MiddleNames <= AllowedNamesGrowth);
+
+	return !HasAnyErrors();
+}
+
+#if WITH_DYNAMIC_LAMBDA_COROUTINES
+// Coroutine awaits the same delegate twice. Every await must be resumed once and release its router right away
+bool FCoroutineResumedOnNextBroadcast::RunTest(const FString& Parameters)
+{
+	UDynamicLambdaTest* Test = NewObject<UDynamicLambdaTest>();
+	UClass* AnonymousClass = FDynamicLambdaManager::Get().GetAnonymousObject()->GetClass();
+	int32 NativeFunctionsNum = AnonymousClass->NativeFunctionLookupTable.Num();
+	int32 Step = 0;
+
+	DynamicLambdaTestInternals::WaitForTwoBroadcasts(Test, &Step);
+	TestEqual("Coroutine is suspended on the first await", Step, 1);
+	TestEqual("One router is created", AnonymousClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum + 1);
+
+	Test->SimpleTestMulticastDelegate.Broadcast();
+	TestEqual("Coroutine is suspended on the second await", Step, 2);
+	TestEqual("First router is released", AnonymousClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum + 1);
+
+	Test->SimpleTestMulticastDelegate.Broadcast();
+	TestEqual("Coroutine is finished", Step, 3);
+	TestEqual("All routers are released", AnonymousClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum);
+	TestFalse("Delegate is unbound", Test->SimpleTestMulticastDelegate.IsBound());
+
+	return Step == 3;
+}
+
+// Coroutine destroyed while it's suspended releases its lambda, so the next broadcast can't resume the freed frame
+bool FDestroyedCoroutineIsNotResumed::RunTest(const FString& Parameters)
+{
+	UDynamicLambdaTest* Test = NewObject<UDynamicLambdaTest>();
+	UClass* AnonymousClass = FDynamicLambdaManager::Get().GetAnonymousObject()->GetClass();
+	int32 NativeFunctionsNum = AnonymousClass->NativeFunctionLookupTable.Num();
+	int32 Step = 0;
+
+	DynamicLambdaTestInternals::FDestroyableTask Task = DynamicLambdaTestInternals::WaitForBroadcast(Test, &Step);
+	TestEqual("One router is created", AnonymousClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum + 1);
+
+	Task.Handle.destroy();
+	TestEqual("Router is released with the coroutine", AnonymousClass->NativeFunctionLookupTable.Num(), NativeFunctionsNum);
+	TestFalse("Delegate is unbound", Test->SimpleTestMulticastDelegate.IsBound());
+
+	Test->SimpleTestMulticastDelegate.Broadcast();
+	TestEqual("Destroyed coroutine isn't resumed", Step, 0);
+
+	return Step == 0;
+}
+#endif // WITH_DYNAMIC_LAMBDA_COROUTINES
+
 #endif // WITH_DEV_AUTOMATION_TESTS
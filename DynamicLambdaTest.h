@@ -1,9 +1,11 @@
 ﻿#pragma once
 #include <Misc/AutomationTest.h>
+#include "DynamicLambdaCoroutine.h"
 #include "DynamicLambdaTest.generated.h"
 
 DECLARE_DYNAMIC_DELEGATE(FSimpleTestDelegate);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FSimpleTestMulticastDelegate);
+DECLARE_DYNAMIC_MULTICAST_SPARSE_DELEGATE(FSimpleTestSparseDelegate, UDynamicLambdaTest, SimpleTestSparseDelegate);
 
 UCLASS()
 class UDynamicLambdaTest : public UObject
@@ -15,6 +17,9 @@ public:
 
 	UPROPERTY()
 	FSimpleTestMulticastDelegate SimpleTestMulticastDelegate;
+
+	UPROPERTY()
+	FSimpleTestSparseDelegate SimpleTestSparseDelegate;
 };
 
 UCLASS()
@@ -52,6 +57,14 @@ public:
 		"Orbit.Generic.DynamicLambda." #Name, \
 		EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter);
 
+// Long running tests, they aren't included in regular test passes
+#define IMPLEMENT_DYNAMIC_LAMBDA_STRESS_TEST(Name) \
+	IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST( \
+		F##Name, \
+		FDynamicLambdaTestBase, \
+		"Orbit.Generic.DynamicLambda.Stress." #Name, \
+		EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::StressFilter);
+
 IMPLEMENT_DYNAMIC_LAMBDA_TEST(BoundToDynamicDelegateLambdaInvoking);
 IMPLEMENT_DYNAMIC_LAMBDA_TEST(BoundToDynamicMulticastDelegateLambdaInvoking);
 IMPLEMENT_DYNAMIC_LAMBDA_TEST(LambdaBoundToDifferentDynamicDelegateInvokingOnlyOncePerExecution);
@@ -62,6 +75,29 @@ IMPLEMENT_DYNAMIC_LAMBDA_TEST(ShortSubscriptionFormTest);
 IMPLEMENT_DYNAMIC_LAMBDA_TEST(BoundWeakLambdaIsDestroyedAfterOwnerDestroy);
 IMPLEMENT_DYNAMIC_LAMBDA_TEST(UFunctionListClearedAfterGC);
 IMPLEMENT_DYNAMIC_LAMBDA_TEST(UFunctionsReusedAfterAfterGC);
+IMPLEMENT_DYNAMIC_LAMBDA_TEST(OneShotLambdaIsReleasedAfterInvocation);
+IMPLEMENT_DYNAMIC_LAMBDA_TEST(LimitedLambdaIsReleasedAfterLastInvocation);
+IMPLEMENT_DYNAMIC_LAMBDA_TEST(LimitedLambdasAreReleasedDuringBroadcast);
+IMPLEMENT_DYNAMIC_LAMBDA_TEST(StatelessLambdasShareRouter);
+IMPLEMENT_DYNAMIC_LAMBDA_TEST(SharedRouterIsRecreatedAfterGC);
+IMPLEMENT_DYNAMIC_LAMBDA_TEST(BoundToSparseDelegateLambdaInvoking);
+IMPLEMENT_DYNAMIC_LAMBDA_TEST(SparseDelegateLambdaIsDestroyedAfterOwnerDestroy);
+IMPLEMENT_DYNAMIC_LAMBDA_TEST(InvokePoliciesCollapseCalls);
+IMPLEMENT_DYNAMIC_LAMBDA_TEST(GroupLambdasAreReleasedTogether);
+IMPLEMENT_DYNAMIC_LAMBDA_TEST(ReleasedGroupScopeFallsBackToWorldGroup);
+IMPLEMENT_DYNAMIC_LAMBDA_TEST(WorldLambdasAreReleasedOnWorldCleanup);
+IMPLEMENT_DYNAMIC_LAMBDA_TEST(SharedRouterLosesWorldBindingsOnWorldCleanup);
+IMPLEMENT_DYNAMIC_LAMBDA_TEST(SharedRouterCleanedUpByGCLeavesWorldGroup);
+#if DYNAMIC_LAMBDA_PROFILER
+IMPLEMENT_DYNAMIC_LAMBDA_TEST(ProfilerCountsInvocationsPerCallSite);
+#endif // DYNAMIC_LAMBDA_PROFILER
+#if WITH_DYNAMIC_LAMBDA_COROUTINES
+IMPLEMENT_DYNAMIC_LAMBDA_TEST(CoroutineResumedOnNextBroadcast);
+IMPLEMENT_DYNAMIC_LAMBDA_TEST(DestroyedCoroutineIsNotResumed);
+#endif // WITH_DYNAMIC_LAMBDA_COROUTINES
+
+IMPLEMENT_DYNAMIC_LAMBDA_STRESS_TEST(GCChurnSoak);
 
 #undef IMPLEMENT_DYNAMIC_LAMBDA_TEST
+#undef IMPLEMENT_DYNAMIC_LAMBDA_STRESS_TEST
 #endif // WITH_DEV_AUTOMATION_TESTS
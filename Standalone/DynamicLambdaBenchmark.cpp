@@ -0,0 +1,83 @@
+﻿#include <benchmark/benchmark.h>
+#include "SyntheticObjects.h"
+
+using namespace DynamicLambdaSynthetic;
+
+namespace
+{
+	constexpr size_t NumObjects = 10'000'000;
+	constexpr size_t NumClasses = 512;
+
+	const FObjects& GetObjects()
+	{
+		static FRandom Random{ 42 };
+		static const FObjects Objects = MakeObjects(Random, NumObjects, NumClasses);
+		return Objects;
+	}
+
+	std::vector<FDelegateToResolve> GetDelegates(size_t NumDelegates)
+	{
+		FRandom Random{ NumDelegates };
+		return PickDelegates(Random, GetObjects(), NumDelegates);
+	}
+}
+
+static void BM_SortDelegatesToResolve(benchmark::State& State)
+{
+	std::vector<FDelegateToResolve> Sorted = GetDelegates(State.range(0));
+	FRandom Random{ 7 };
+
+	for (auto _ : State)
+	{
+		State.PauseTiming();
+		std::vector<FDelegateToResolve> Delegates = Sorted;
+		for (size_t Idx = Delegates.size(); Idx > 1; --Idx)
+		{
+			std::swap(Delegates[Idx - 1], Delegates[Random.Next(static_cast<uint32_t>(Idx))]);
+		}
+		State.ResumeTiming();
+
+		DynamicLambdaCore::SortByAddress(Delegates.begin(), Delegates.end(), GetPointer);
+		benchmark::DoNotOptimize(Delegates.data());
+	}
+	State.SetItemsProcessed(State.iterations() * Sorted.size());
+}
+BENCHMARK(BM_SortDelegatesToResolve)->RangeMultiplier(16)->Range(16, 65536);
+
+template <size_t (*Resolve)(const FObjects&, std::vector<FDelegateToResolve>&)>
+static void BM_Resolve(benchmark::State& State)
+{
+	const FObjects& Objects = GetObjects();
+	const std::vector<FDelegateToResolve> Delegates = GetDelegates(State.range(0));
+
+	for (auto _ : State)
+	{
+		std::vector<FDelegateToResolve> ToResolve = Delegates;
+		benchmark::DoNotOptimize(Resolve(Objects, ToResolve));
+	}
+	State.SetItemsProcessed(State.iterations() * Objects.Addresses.size());
+}
+BENCHMARK_TEMPLATE(BM_Resolve, ResolveNaive)->Arg(16)->Arg(64)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Resolve, ResolveByIntervals)->Arg(16)->Arg(64)->Arg(4096)->Arg(65536)->Unit(benchmark::kMillisecond);
+
+static void BM_SlotPoolReuse(benchmark::State& State)
+{
+	DynamicLambdaCore::TSlotPool<void*> Pool;
+	std::vector<void*> Acquired(State.range(0));
+
+	for (auto _ : State)
+	{
+		for (void*& Slot : Acquired)
+		{
+			Slot = Pool.IsEmpty() ? &Slot : Pool.Acquire();
+		}
+		for (void* Slot : Acquired)
+		{
+			Pool.Release(Slot);
+		}
+	}
+	State.SetItemsProcessed(State.iterations() * Acquired.size());
+}
+BENCHMARK(BM_SlotPoolReuse)->Arg(1024)->Arg(65536);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,128 @@
+﻿#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "SyntheticObjects.h"
+
+using namespace DynamicLambdaSynthetic;
+
+// Fuzz target: resolving of DynamicLambdaCore must find exactly the same owners as naive resolving
+// Input bytes seed the object layout, so the fuzzer explores class sizes, gaps, delegate sets and thread chunks
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* Data, size_t Size)
+{
+	if (Size < 12)
+	{
+		return 0;
+	}
+
+	uint64_t Seed;
+	memcpy(&Seed, Data, sizeof(Seed));
+	FRandom Random{ Seed };
+	size_t NumObjects = 1 + (Data[8] | (Data[9] << 8)) % 4096;
+	size_t NumClasses = 1 + Data[10] % 32;
+	size_t NumChunks = 1 + (Data[10] >> 5);
+	size_t NumDelegates = 1 + Data[11] % 128;
+
+	FObjects Objects = MakeObjects(Random, NumObjects, NumClasses);
+	std::vector<FDelegateToResolve> Delegates = PickDelegates(Random, Objects, NumDelegates);
+
+	// pointers nobody owns: dangling delegates that must stay unresolved
+	for (size_t Idx = 12; Idx + 4 <= Size; Idx += 4)
+	{
+		uint32_t Address;
+		memcpy(&Address, Data + Idx, sizeof(Address));
+		Delegates.push_back({ reinterpret_cast<const void*>(static_cast<uintptr_t>(Address) | 1) });
+	}
+
+	if (Delegates.empty())
+	{
+		return 0;
+	}
+
+	DynamicLambdaCore::SortByAddress(Delegates.begin(), Delegates.end(), GetPointer);
+	for (size_t Idx = 1; Idx < Delegates.size(); ++Idx)
+	{
+		if (Delegates[Idx].Pointer < Delegates[Idx - 1].Pointer)
+		{
+			fprintf(stderr, "Delegates aren't sorted\n");
+			abort();
+		}
+	}
+
+	std::vector<FDelegateToResolve> Expected = Delegates;
+	size_t ExpectedResolved = ResolveNaive(Objects, Expected);
+	size_t Resolved = ResolveByChunks(Objects, Delegates, NumChunks);
+
+	if (Resolved != ExpectedResolved)
+	{
+		fprintf(stderr, "Resolved %zu delegates, expected %zu\n", Resolved, ExpectedResolved);
+		abort();
+	}
+
+	for (size_t Idx = 0; Idx != Delegates.size(); ++Idx)
+	{
+		if (Delegates[Idx].Owner != Expected[Idx].Owner)
+		{
+			fprintf(stderr, "Delegate %p: owner %lld, expected %lld\n", Delegates[Idx].Pointer,
+				static_cast<long long>(Delegates[Idx].Owner), static_cast<long long>(Expected[Idx].Owner));
+			abort();
+		}
+	}
+
+	return 0;
+}
+
+#if !DYNAMIC_LAMBDA_WITH_LIBFUZZER
+// Replay driver for toolchains without libFuzzer: runs given input files or N pseudo-random inputs (-runs=N)
+int main(int Argc, char** Argv)
+{
+	size_t Runs = 10000;
+	int NumFiles = 0;
+
+	for (int Idx = 1; Idx < Argc; ++Idx)
+	{
+		if (strncmp(Argv[Idx], "-runs=", 6) == 0)
+		{
+			Runs = strtoull(Argv[Idx] + 6, nullptr, 10);
+			continue;
+		}
+
+		FILE* File = fopen(Argv[Idx], "rb");
+		if (File == nullptr)
+		{
+			fprintf(stderr, "Can't open %s\n", Argv[Idx]);
+			return 1;
+		}
+
+		std::vector<uint8_t> Input;
+		uint8_t Buffer[4096];
+		for (size_t Read; (Read = fread(Buffer, 1, sizeof(Buffer), File)) != 0;)
+		{
+			Input.insert(Input.end(), Buffer, Buffer + Read);
+		}
+		fclose(File);
+
+		LLVMFuzzerTestOneInput(Input.data(), Input.size());
+		++NumFiles;
+	}
+
+	if (NumFiles != 0)
+	{
+		return 0;
+	}
+
+	FRandom Random{ 1 };
+	for (size_t Run = 0; Run != Runs; ++Run)
+	{
+		std::vector<uint8_t> Input(12 + 4 * Random.Next(16));
+		for (uint8_t& Byte : Input)
+		{
+			Byte = static_cast<uint8_t>(Random.Next());
+		}
+
+		LLVMFuzzerTestOneInput(Input.data(), Input.size());
+	}
+
+	printf("Done %zu runs\n", Runs);
+	return 0;
+}
+#endif // !DYNAMIC_LAMBDA_WITH_LIBFUZZER
@@ -0,0 +1,183 @@
+﻿#pragma once
+#include <cstdint>
+#include <vector>
+#include "DynamicLambdaCore.h"
+
+// Synthetic model of the global UObject array: objects are address ranges of some class, and delegate properties
+// are offsets inside them. Addresses are never dereferenced, so any number of objects can be modeled cheaply
+namespace DynamicLambdaSynthetic
+{
+	struct FClass
+	{
+		uint32_t Size;
+		std::vector<uint32_t> DelegateOffsets; /* offsets of delegate properties */
+	};
+
+	struct FObjects
+	{
+		std::vector<FClass> Classes;
+		std::vector<uintptr_t> Addresses; /* object index -> object address */
+		std::vector<uint16_t> ClassIndices; /* object index -> class index */
+
+		const void* GetObject(size_t Index) const { return reinterpret_cast<const void*>(Addresses[Index]); }
+		const FClass& GetClass(size_t Index) const { return Classes[ClassIndices[Index]]; }
+	};
+
+	// Mirrors FDelegateResolvingData: delegate pointer and the slot for resolved owner
+	struct FDelegateToResolve
+	{
+		const void* Pointer;
+		int64_t Owner = -1;
+	};
+
+	inline const void* GetPointer(const FDelegateToResolve& Item) { return Item.Pointer; }
+
+	// Tiny deterministic generator: benchmarks and fuzz replay must be reproducible
+	struct FRandom
+	{
+		uint64_t State;
+
+		uint32_t Next()
+		{
+			State = State * 6364136223846793005ull + 1442695040888963407ull;
+			return static_cast<uint32_t>(State >> 33);
+		}
+
+		uint32_t Next(uint32_t Max) { return Max == 0 ? 0 : Next() % Max; }
+	};
+
+	inline FObjects MakeObjects(FRandom& Random, size_t NumObjects, size_t NumClasses)
+	{
+		FObjects Objects;
+		for (size_t Idx = 0; Idx != NumClasses; ++Idx)
+		{
+			FClass Class;
+			Class.Size = 48 + 8 * Random.Next(128);
+			for (uint32_t Offset = 40; Offset + 16 <= Class.Size; Offset += 8 + 8 * Random.Next(32))
+			{
+				Class.DelegateOffsets.push_back(Offset);
+			}
+			Objects.Classes.push_back(Class);
+		}
+
+		// Objects are laid out one by one with random gaps, like allocator does
+		uintptr_t Address = 0x10000;
+		Objects.Addresses.reserve(NumObjects);
+		Objects.ClassIndices.reserve(NumObjects);
+		for (size_t Idx = 0; Idx != NumObjects; ++Idx)
+		{
+			uint16_t ClassIndex = static_cast<uint16_t>(Random.Next(static_cast<uint32_t>(NumClasses)));
+			Objects.Addresses.push_back(Address);
+			Objects.ClassIndices.push_back(ClassIndex);
+			Address += Objects.Classes[ClassIndex].Size + 16 * Random.Next(4);
+		}
+
+		return Objects;
+	}
+
+	inline std::vector<FDelegateToResolve> PickDelegates(FRandom& Random, const FObjects& Objects, size_t NumDelegates)
+	{
+		std::vector<FDelegateToResolve> Delegates;
+		for (size_t Idx = 0; Idx != NumDelegates; ++Idx)
+		{
+			size_t Object = Random.Next(static_cast<uint32_t>(Objects.Addresses.size()));
+			const FClass& Class = Objects.GetClass(Object);
+			if (Class.DelegateOffsets.empty())
+			{
+				continue;
+			}
+
+			uint32_t Offset = Class.DelegateOffsets[Random.Next(static_cast<uint32_t>(Class.DelegateOffsets.size()))];
+			Delegates.push_back({ reinterpret_cast<const void*>(Objects.Addresses[Object] + Offset) });
+		}
+
+		// every delegate is bound to lambda only once
+		DynamicLambdaCore::SortByAddress(Delegates.begin(), Delegates.end(), GetPointer);
+		Delegates.erase(std::unique(Delegates.begin(), Delegates.end(), [] (const auto& Lhs, const auto& Rhs)
+		{
+			return Lhs.Pointer == Rhs.Pointer;
+		}), Delegates.end());
+
+		return Delegates;
+	}
+
+	// Resolving as it was before the core: every property is compared with every delegate
+	inline size_t ResolveNaive(const FObjects& Objects, std::vector<FDelegateToResolve>& Delegates)
+	{
+		size_t Resolved = 0;
+		const void* MaxDelegatePtr = Delegates.back().Pointer;
+		for (size_t Idx = 0; Idx != Objects.Addresses.size() && Resolved != Delegates.size(); ++Idx)
+		{
+			const char* Object = static_cast<const char*>(Objects.GetObject(Idx));
+			if (MaxDelegatePtr < Object)
+			{
+				continue;
+			}
+
+			for (uint32_t Offset : Objects.GetClass(Idx).DelegateOffsets)
+			{
+				for (FDelegateToResolve& Delegate : Delegates)
+				{
+					if (Object + Offset == Delegate.Pointer)
+					{
+						Delegate.Owner = static_cast<int64_t>(Idx);
+						++Resolved;
+					}
+				}
+			}
+		}
+
+		return Resolved;
+	}
+
+	// Synthetic object as DynamicLambdaCore resolving sees it, the same role FResolvingObject plays for UObjects
+	struct FResolvingObject
+	{
+		const FObjects& Objects;
+		size_t Index;
+		size_t& Resolved;
+
+		const void* GetAddress() const { return Objects.GetObject(Index); }
+		size_t GetSize() const { return Objects.GetClass(Index).Size; }
+		bool ShouldSkip() const { return false; }
+
+		template <typename TVisitor>
+		void ForEachProperty(TVisitor&& Visitor) const
+		{
+			for (uint32_t Offset : Objects.GetClass(Index).DelegateOffsets)
+			{
+				Visitor(Offset, Offset);
+			}
+		}
+
+		// every synthetic property at the delegate's offset is the delegate
+		bool TryResolve(FDelegateToResolve& Delegate, uint32_t) const
+		{
+			Delegate.Owner = static_cast<int64_t>(Index);
+			++Resolved;
+			return true;
+		}
+	};
+
+	// Resolving the way FDynamicLambdaManager::ResolveDelegates does it: one chunk of objects per thread,
+	// chunks are processed one by one here and every chunk stops once all delegates are resolved
+	inline size_t ResolveByChunks(const FObjects& Objects, std::vector<FDelegateToResolve>& Delegates, size_t NumChunks)
+	{
+		size_t Resolved = 0;
+		auto GetObject = [&] (size_t Index) { return FResolvingObject{ Objects, Index, Resolved }; };
+		auto IsDone = [&] { return Resolved == Delegates.size(); };
+
+		for (size_t Chunk = 0; Chunk != NumChunks; ++Chunk)
+		{
+			std::pair<size_t, size_t> Range = DynamicLambdaCore::GetChunk(0, Objects.Addresses.size(), NumChunks, Chunk);
+			DynamicLambdaCore::ResolveObjects(Range.first, Range.second, Delegates.begin(), Delegates.end(), GetPointer, GetObject, IsDone);
+		}
+
+		return Resolved;
+	}
+
+	inline size_t ResolveByIntervals(const FObjects& Objects, std::vector<FDelegateToResolve>& Delegates)
+	{
+		return ResolveByChunks(Objects, Delegates, 1);
+	}
+}